@@ -0,0 +1,158 @@
+#include "alloc_tracker.h"
+#include "logger.h"
+#include "options.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    const int MAX_THREADS = 32;         // threads beyond this share the last slot
+    const int MAX_REPORTED_FRAMES = 10; // steady frames logged individually by --assert-zero-alloc
+
+    // written by the owning thread, read by the report; nothing here may allocate
+    struct ThreadSlot {
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> frees{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<const char*> name{nullptr};
+    };
+
+    ThreadSlot slots[MAX_THREADS];
+    std::atomic<int> slot_count(0);
+    thread_local ThreadSlot* thread_slot = nullptr;
+
+    // frame accounting, render thread only
+    alloc_tracker::FrameStats frame_stats = {};
+    alloc_tracker::Counters frame_start = {};
+    bool frame_steady = false;
+
+    ThreadSlot& Slot() {
+        if (!thread_slot) {
+            int index = slot_count.fetch_add(1, std::memory_order_relaxed);
+            thread_slot = &slots[index < MAX_THREADS ? index : MAX_THREADS - 1];
+        }
+        return *thread_slot;
+    }
+
+#ifdef TRACK_ALLOCATIONS
+    void CountAllocation(size_t size) {
+        ThreadSlot& slot = Slot();
+        slot.allocations.fetch_add(1, std::memory_order_relaxed);
+        slot.bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void CountFree(void* pointer) {
+        if (pointer) Slot().frees.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void* Allocate(size_t size) {
+        CountAllocation(size);
+        void* pointer = malloc(size ? size : 1);
+        if (!pointer) throw std::bad_alloc();
+        return pointer;
+    }
+
+    void* AllocateAligned(size_t size, std::align_val_t alignment) {
+        CountAllocation(size);
+        void* pointer = nullptr;
+        if (posix_memalign(&pointer, static_cast<size_t>(alignment), size ? size : 1) != 0) throw std::bad_alloc();
+        return pointer;
+    }
+#endif
+}
+
+#ifdef TRACK_ALLOCATIONS
+void* operator new(size_t size) { return Allocate(size); }
+void* operator new[](size_t size) { return Allocate(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return AllocateAligned(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return AllocateAligned(size, alignment); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    CountAllocation(size);
+    return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    CountAllocation(size);
+    return malloc(size ? size : 1);
+}
+
+void operator delete(void* pointer) noexcept { CountFree(pointer); free(pointer); }
+void operator delete[](void* pointer) noexcept { CountFree(pointer); free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { CountFree(pointer); free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { CountFree(pointer); free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { CountFree(pointer); free(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { CountFree(pointer); free(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { CountFree(pointer); free(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { CountFree(pointer); free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { CountFree(pointer); free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { CountFree(pointer); free(pointer); }
+#endif
+
+namespace alloc_tracker {
+    bool Enabled() {
+#ifdef TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void NameThread(const char* name) {
+        Slot().name.store(name, std::memory_order_relaxed);
+    }
+
+    Counters ThreadCounters() {
+        ThreadSlot& slot = Slot();
+        return {slot.allocations.load(std::memory_order_relaxed), slot.frees.load(std::memory_order_relaxed),
+                slot.bytes.load(std::memory_order_relaxed)};
+    }
+
+    void SetFrameSteady(bool steady) {
+        frame_steady = steady;
+    }
+
+    void EndFrame() {
+        Counters now = ThreadCounters();
+        uint64_t allocations = now.allocations - frame_start.allocations;
+        uint64_t bytes = now.bytes - frame_start.bytes;
+        frame_start = now;
+
+        if (!frame_steady) {
+            frame_stats.otherFrames++;
+            frame_stats.otherAllocations += allocations;
+            return;
+        }
+        frame_steady = false;
+        frame_stats.steadyFrames++;
+        frame_stats.steadyAllocations += allocations;
+        frame_stats.steadyBytes += bytes;
+        if (allocations > frame_stats.worstFrameAllocations) frame_stats.worstFrameAllocations = allocations;
+        if (allocations == 0) return;
+        if (options.assertZeroAlloc && frame_stats.steadyAllocFrames < MAX_REPORTED_FRAMES) {
+            logger::Warn("Steady-state frame %u allocated %u times (%u bytes)", frame_stats.steadyFrames, allocations, bytes);
+        }
+        frame_stats.steadyAllocFrames++;
+    }
+
+    FrameStats GetFrameStats() {
+        return frame_stats;
+    }
+
+    void PrintAllocStats() {
+        if (!Enabled()) return;
+        const FrameStats& f = frame_stats;
+        logger::Info("Allocations: %u steady frames, %u of them allocated (%u allocations, %u bytes, worst %u in one frame)",
+                     f.steadyFrames, f.steadyAllocFrames, f.steadyAllocations, f.steadyBytes, f.worstFrameAllocations);
+        logger::Info("  %u other frames with %u allocations", f.otherFrames, f.otherAllocations);
+        int count = slot_count.load(std::memory_order_relaxed);
+        if (count > MAX_THREADS) count = MAX_THREADS;
+        for (int i = 0; i < count; i++) {
+            const ThreadSlot& slot = slots[i];
+            const char* name = slot.name.load(std::memory_order_relaxed);
+            logger::Info("  %s (thread %d): %u allocations, %u frees, %u bytes", name ? name : "unnamed", i,
+                         slot.allocations.load(std::memory_order_relaxed), slot.frees.load(std::memory_order_relaxed),
+                         slot.bytes.load(std::memory_order_relaxed));
+        }
+    }
+}
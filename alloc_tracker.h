@@ -0,0 +1,40 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <stdint.h>
+
+// heap allocation counters fed by global operator new/delete hooks
+// the hooks are only compiled in with -DTRACK_ALLOCATIONS (make alloc-check); otherwise every
+// counter reads zero and the frame hooks cost nothing
+namespace alloc_tracker {
+    struct Counters {
+        uint64_t allocations;
+        uint64_t frees;
+        uint64_t bytes;     // requested by operator new, frees are not subtracted
+    };
+
+    struct FrameStats {
+        uint64_t steadyFrames;          // frames the game marked as steady state (PLAYING)
+        uint64_t steadyAllocFrames;     // steady frames that allocated at least once
+        uint64_t steadyAllocations;
+        uint64_t steadyBytes;
+        uint64_t worstFrameAllocations;
+        uint64_t otherFrames;
+        uint64_t otherAllocations;
+    };
+
+    bool Enabled();
+
+    // label the calling thread in the report; the pointer must outlive the thread
+    void NameThread(const char* name);
+    Counters ThreadCounters();
+
+    // render thread: mark the frame being built as steady state, then close it once per frame
+    void SetFrameSteady(bool steady);
+    void EndFrame();
+
+    FrameStats GetFrameStats();
+    void PrintAllocStats();
+}
+
+#endif
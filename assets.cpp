@@ -1,7 +1,30 @@
 #include "assets.h"
+#include "governor.h"
+#include "resources.h"
+#include "softraster.h"
+#include "telemetry.h"
+
+static const int HEAD_RADIUS = static_cast<int>(PLAYER_SIZE * 0.25f);
+static const int SHIELD_RADIUS = HEAD_RADIUS + 2;  // slightly larger than the head
+static const SDL_Color SKIN_COLOR = {255, 224, 189, 255};
+static const SDL_Color SHIELD_COLOR = {169, 169, 169, 255};    // shield silver
+
+static SDL_Texture* head_sprite = nullptr;
+static SDL_Texture* shield_sprite = nullptr;
+
+// colour set by the last SDL_SetRenderDrawColor, for the software rasterizer
+static SDL_Color DrawColor(SDL_Renderer* renderer) {
+    SDL_Color color;
+    SDL_GetRenderDrawColor(renderer, &color.r, &color.g, &color.b, &color.a);
+    return color;
+}
 
 // helper function to draw a circle outline using points
 void DrawCircle(SDL_Renderer* renderer, int centreX, int centreY, int radius) {
+    if (softraster::Active()) {
+        softraster::DrawCircle(centreX, centreY, radius, DrawColor(renderer));
+        return;
+    }
     const int diameter = (radius * 2);
     int x = (radius - 1); int y = 0; int tx = 1; int ty = 1;
     int error = (tx - diameter);
@@ -10,6 +33,7 @@ void DrawCircle(SDL_Renderer* renderer, int centreX, int centreY, int radius) {
         SDL_RenderDrawPoint(renderer, centreX - x, centreY - y); SDL_RenderDrawPoint(renderer, centreX - x, centreY + y);
         SDL_RenderDrawPoint(renderer, centreX + y, centreY - x); SDL_RenderDrawPoint(renderer, centreX + y, centreY + x);
         SDL_RenderDrawPoint(renderer, centreX - y, centreY - x); SDL_RenderDrawPoint(renderer, centreX - y, centreY + x);
+        telemetry::CountDrawCalls(8);
         if (error <= 0) { ++y; error += ty; ty += 2; }
         if (error > 0) { --x; tx += 2; error += (tx - diameter); }
     }
@@ -17,17 +41,64 @@ void DrawCircle(SDL_Renderer* renderer, int centreX, int centreY, int radius) {
 
 // helper function to draw a filled circle by drawing horizontal lines
 void FillCircle(SDL_Renderer* renderer, int centreX, int centreY, int radius) {
+    if (softraster::Active()) {
+        softraster::FillCircle(centreX, centreY, radius, DrawColor(renderer));
+        return;
+    }
     for (int w = 0; w < radius * 2; w++) {
         for (int h = 0; h < radius * 2; h++) {
             int dx = radius - w; // horizontal offset
             int dy = radius - h; // vertical offset
             if ((dx*dx + dy*dy) <= (radius * radius)) {
                 SDL_RenderDrawPoint(renderer, centreX + dx, centreY + dy);
+                telemetry::CountDrawCalls(1);
             }
         }
     }
 }
 
+// filled circle with a one pixel black outline, the same shape FillCircle + DrawCircle produce
+static SDL_Surface* CircleSurface(int radius, SDL_Color fill) {
+    int size = radius * 2 + 1;
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!surface) return nullptr;
+    Uint32 inside = SDL_MapRGBA(surface->format, fill.r, fill.g, fill.b, 255);
+    Uint32 edge = SDL_MapRGBA(surface->format, 0, 0, 0, 255);
+    Uint32 clear = SDL_MapRGBA(surface->format, 0, 0, 0, 0);
+    int outer = radius * radius, inner = (radius - 1) * (radius - 1);
+    for (int y = 0; y < size; y++) {
+        Uint32* row = reinterpret_cast<Uint32*>(static_cast<Uint8*>(surface->pixels) + y * surface->pitch);
+        for (int x = 0; x < size; x++) {
+            int dx = x - radius, dy = y - radius;
+            int distance = dx * dx + dy * dy;
+            row[x] = distance > outer ? clear : (distance >= inner ? edge : inside);
+        }
+    }
+    return surface;
+}
+
+void LoadPlayerSprites(SDL_Renderer* renderer) {
+    head_sprite = resources::AcquireTexture(renderer, "player_head", [] { return CircleSurface(HEAD_RADIUS, SKIN_COLOR); });
+    shield_sprite = resources::AcquireTexture(renderer, "player_shield", [] { return CircleSurface(SHIELD_RADIUS, SHIELD_COLOR); });
+}
+
+void ReleasePlayerSprites(SDL_Renderer* renderer) {
+    if (head_sprite) resources::ReleaseTexture(renderer, "player_head");
+    if (shield_sprite) resources::ReleaseTexture(renderer, "player_shield");
+    head_sprite = shield_sprite = nullptr;
+}
+
+// one copy of a circle sprite centred on (x, y); a plain square if the sprite could not be made
+static void DrawSprite(SDL_Renderer* renderer, SDL_Texture* sprite, int x, int y, int radius, SDL_Color fallback) {
+    SDL_Rect dst = {x - radius, y - radius, radius * 2 + 1, radius * 2 + 1};
+    if (sprite) SDL_RenderCopy(renderer, sprite, nullptr, &dst);
+    else {
+        SDL_SetRenderDrawColor(renderer, fallback.r, fallback.g, fallback.b, 255);
+        SDL_RenderFillRect(renderer, &dst);
+    }
+    telemetry::CountDrawCalls(1);
+}
+
 // render the player character, shield position indicates facing direction
 void RenderPlayerCharacter(SDL_Renderer* renderer, const Player& player, bool isGameOver, int Game_Type) {
     // calculate base character dimensions and positions
@@ -35,7 +106,7 @@ void RenderPlayerCharacter(SDL_Renderer* renderer, const Player& player, bool is
     int centerY = static_cast<int>(player.y);
     int bodyHeight = PLAYER_SIZE;
     int bodyWidth = static_cast<int>(PLAYER_SIZE * 0.6f);
-    int headRadius = static_cast<int>(bodyHeight * 0.25f);
+    int headRadius = HEAD_RADIUS;
     int headY = centerY - static_cast<int>(bodyHeight * 0.25f);
 
     SDL_Rect bodyRect;
@@ -44,35 +115,70 @@ void RenderPlayerCharacter(SDL_Renderer* renderer, const Player& player, bool is
     bodyRect.x = centerX - bodyWidth / 2;
     bodyRect.y = headY + headRadius - 5;
 
-    // determine body color based on game over state
-    SDL_Color bodyColor = {0, 128, 0, 255}; // normal green
+    // determine body color based on player and game over state
+    static const SDL_Color BODY_COLORS[VERSUS_PLAYERS] = {
+        {0, 128, 0, 255},   // player 1 green
+        {150, 40, 150, 255} // player 2 purple
+    };
+    SDL_Color bodyColor = BODY_COLORS[player.index % VERSUS_PLAYERS];
     if (isGameOver) {
-        bodyColor = {0, 60, 0, 255};        // darker green
+        bodyColor.r /= 2;                   // darker
+        bodyColor.g /= 2;
+        bodyColor.b /= 2;
     }
 
+    // under load the governor drops the outlines, then swaps the circles for sprites
+    bool outlines = !governor::AtLeast(governor::Level::NO_OUTLINES);
+    // spans are already cheaper than a sprite copy on the software rasterizer
+    bool sprites = governor::AtLeast(governor::Level::SPRITES) && !softraster::Active();
+
     // draw base character
     // head
-    SDL_SetRenderDrawColor(renderer, 255, 224, 189, 255);   // skin color
-    FillCircle(renderer, centerX, headY, headRadius);       // fill head
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);         // black outline for head
-    DrawCircle(renderer, centerX, headY, headRadius);       // outline head
+    if (sprites) DrawSprite(renderer, head_sprite, centerX, headY, headRadius, SKIN_COLOR);
+    else {
+        SDL_SetRenderDrawColor(renderer, SKIN_COLOR.r, SKIN_COLOR.g, SKIN_COLOR.b, 255);
+        FillCircle(renderer, centerX, headY, headRadius);       // fill head
+        if (outlines) {
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);     // black outline for head
+            DrawCircle(renderer, centerX, headY, headRadius);   // outline head
+        }
+    }
     // body
     SDL_SetRenderDrawColor(renderer, bodyColor.r, bodyColor.g, bodyColor.b, bodyColor.a);
-    SDL_RenderFillRect(renderer, &bodyRect);
+    if (softraster::Active()) softraster::FillRect(bodyRect, bodyColor);
+    else {
+        SDL_RenderFillRect(renderer, &bodyRect);
+        telemetry::CountDrawCalls(1);
+    }
     // eyes
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);         // Black
     int eyeOffsetX = headRadius / 2;
     int eyeOffsetY = headRadius / 4;
     // draw slightly larger eyes
-    FillCircle(renderer, centerX - eyeOffsetX, headY - eyeOffsetY, 2);
-    FillCircle(renderer, centerX + eyeOffsetX, headY - eyeOffsetY, 2);
+    if (sprites) {
+        SDL_Rect eyes[2] = {{centerX - eyeOffsetX - 2, headY - eyeOffsetY - 2, 4, 4},
+                            {centerX + eyeOffsetX - 2, headY - eyeOffsetY - 2, 4, 4}};
+        SDL_RenderFillRects(renderer, eyes, 2);
+        telemetry::CountDrawCalls(1);
+    }
+    else {
+        FillCircle(renderer, centerX - eyeOffsetX, headY - eyeOffsetY, 2);
+        FillCircle(renderer, centerX + eyeOffsetX, headY - eyeOffsetY, 2);
+    }
     // mouth
     int mouthY = headY + eyeOffsetY;
-    SDL_RenderDrawLine(renderer, centerX - eyeOffsetX, mouthY, centerX + eyeOffsetX, mouthY);
+    if (softraster::Active()) {
+        SDL_Rect mouth = {centerX - eyeOffsetX, mouthY, eyeOffsetX * 2 + 1, 1};
+        softraster::FillRect(mouth, {0, 0, 0, 255});
+    }
+    else {
+        SDL_RenderDrawLine(renderer, centerX - eyeOffsetX, mouthY, centerX + eyeOffsetX, mouthY);
+        telemetry::CountDrawCalls(1);
+    }
 
     // draw shield based on player.facing (only if not game over)
     if (!isGameOver) {
-        int shieldRadius = headRadius + 2; // slightly larger shield
+        int shieldRadius = SHIELD_RADIUS;
         int shieldX = centerX;
         int shieldY = centerY;
 
@@ -98,11 +204,16 @@ void RenderPlayerCharacter(SDL_Renderer* renderer, const Player& player, bool is
         }
 
         if (Game_Type == 1) {
-            // draw the shield: fill first, then outline
-            SDL_SetRenderDrawColor(renderer, 169, 169, 169, 255);   // shield silver
-            FillCircle(renderer, shieldX, shieldY, shieldRadius);   // use FillCircle
-            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);         // shield outline (black)
-            DrawCircle(renderer, shieldX, shieldY, shieldRadius);   // use DrawCircle for outline
+            if (sprites) DrawSprite(renderer, shield_sprite, shieldX, shieldY, shieldRadius, SHIELD_COLOR);
+            else {
+                // draw the shield: fill first, then outline
+                SDL_SetRenderDrawColor(renderer, SHIELD_COLOR.r, SHIELD_COLOR.g, SHIELD_COLOR.b, 255);
+                FillCircle(renderer, shieldX, shieldY, shieldRadius);   // use FillCircle
+                if (outlines) {
+                    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);     // shield outline (black)
+                    DrawCircle(renderer, shieldX, shieldY, shieldRadius);
+                }
+            }
         }
     }
 }
@@ -135,5 +246,11 @@ void RenderSpear(SDL_Renderer* renderer, const Spear& spear) {
             break;
         case Direction::NONE: return;
     }
+    if (softraster::Active()) {
+        SDL_FPoint points[3] = {vertex[0].position, vertex[1].position, vertex[2].position};
+        softraster::FillTriangle(points, vertex[0].color);
+        return;
+    }
     SDL_RenderGeometry(renderer, nullptr, vertex, 3, nullptr, 0);
+    telemetry::CountDrawCalls(1);
 }
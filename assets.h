@@ -10,25 +10,41 @@ static const int PLAYER_SPEED = 5;
 // for spears
 const int SPEAR_BASE_WIDTH = 5;
 const int SPEAR_LENGTH = 20;
+// spear vectors are reserved to this once, so spawning never allocates mid-game;
+// well above what any difficulty keeps on screen
+const size_t MAX_SPEARS = 64;
 
 enum class Direction {
     NONE, UP, DOWN, LEFT, RIGHT
 };
 
+// local versus modes: player N is driven by input channel N
+const int VERSUS_PLAYERS = 2;
+
 struct Player {
     SDL_Rect rect;
     Direction facing;
     float x, y;
+    int index = 0;      // 0 = player 1, picks the body colour
 };
 
 struct Spear {
     SDL_Rect rect;
+    SDL_Rect previous;  // rect at the start of the last tick, for swept collision
     Direction originDirection;
     float x, y;
     int speed;
+    int target = 0;     // player the spear was thrown at, versus blocker only
 };
 
+void DrawCircle(SDL_Renderer* renderer, int centreX, int centreY, int radius);
+void FillCircle(SDL_Renderer* renderer, int centreX, int centreY, int radius);
 void RenderPlayerCharacter(SDL_Renderer* renderer, const Player& player, bool isGameOver, int Game_Type);
 void RenderSpear(SDL_Renderer* renderer, const Spear& spear);
 
+// head and shield sprites used when the governor drops to Level::SPRITES; acquired once at
+// startup so switching levels mid-game never generates a texture
+void LoadPlayerSprites(SDL_Renderer* renderer);
+void ReleasePlayerSprites(SDL_Renderer* renderer);
+
 #endif // ASSETS_H
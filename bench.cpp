@@ -0,0 +1,284 @@
+// microbenchmarks for the game hot loops and the render helpers
+// usage: game_bench [--reps N] [--warmup N] [--filter substring] [--json path]
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "assets.h"
+#include "menu.h"
+#include "resources.h"
+#include "softraster.h"
+#include "spear_blocker.h"
+#include "spear_runner.h"
+
+namespace {
+    // the games never hold more than MAX_SPEARS live spears
+    const int SPEAR_COUNTS[] = {8, 32, static_cast<int>(MAX_SPEARS)};
+    const int BATCH = 64;   // calls timed together so the clock resolution does not dominate
+
+    struct BenchOptions {
+        int warmup = 20;
+        int reps = 200;
+        std::string filter;
+        std::string jsonPath;
+    };
+
+    struct BenchResult {
+        std::string name;
+        std::string params;
+        int reps;
+        double medianNs, p99Ns, minNs, meanNs;  // per call
+    };
+
+    BenchOptions options;
+    std::vector<BenchResult> results;
+
+    double NowNs() {
+        return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // setup() runs untimed before every repetition, body(i) is timed for i in [0, BATCH)
+    void RunBench(const std::string& name, const std::string& params, const std::function<void()>& setup,
+                  const std::function<void(int)>& body, const std::function<void()>& flush = [] {}) {
+        std::string fullName = name + " " + params;
+        if (!options.filter.empty() && fullName.find(options.filter) == std::string::npos) return;
+
+        std::vector<double> samples;
+        samples.reserve(options.reps);
+        for (int rep = 0; rep < options.warmup + options.reps; rep++) {
+            setup();
+            double start = NowNs();
+            for (int i = 0; i < BATCH; i++) body(i);
+            flush();
+            double elapsed = (NowNs() - start) / BATCH;
+            if (rep >= options.warmup) samples.push_back(elapsed);
+        }
+
+        std::sort(samples.begin(), samples.end());
+        BenchResult result;
+        result.name = name;
+        result.params = params;
+        result.reps = options.reps;
+        result.medianNs = samples[samples.size() / 2];
+        result.p99Ns = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+        result.minNs = samples.front();
+        double total = 0;
+        for (double sample : samples) total += sample;
+        result.meanNs = total / samples.size();
+        results.push_back(result);
+
+        printf("%-44s %-28s median %10.1f ns  p99 %10.1f ns\n", name.c_str(), params.c_str(), result.medianNs, result.p99Ns);
+    }
+
+    void WriteJson(const std::string& path) {
+        std::ofstream out(path);
+        out << "{\n  \"batch\": " << BATCH << ",\n  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchResult& r = results[i];
+            out << "    {\"name\": \"" << r.name << "\", \"params\": \"" << r.params << "\", \"reps\": " << r.reps
+                << ", \"median_ns\": " << r.medianNs << ", \"p99_ns\": " << r.p99Ns
+                << ", \"min_ns\": " << r.minNs << ", \"mean_ns\": " << r.meanNs << "}"
+                << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+    }
+
+    const char* DifficultyName(int difficulty) {
+        static const char* names[] = {"easy", "medium", "hard"};
+        return names[difficulty];
+    }
+
+    std::string Params(int spears, int difficulty) {
+        return "spears=" + std::to_string(spears) + " difficulty=" + DifficultyName(difficulty);
+    }
+
+    Player CenteredPlayer() {
+        Player player;
+        player.x = SCREEN_WIDTH / 2.0f;
+        player.y = SCREEN_HEIGHT / 2.0f;
+        player.rect = {static_cast<int>(player.x) - PLAYER_SIZE / 2, static_cast<int>(player.y) - PLAYER_SIZE / 2, PLAYER_SIZE, PLAYER_SIZE};
+        player.facing = Direction::UP;
+        return player;
+    }
+
+    // spears spawned by the game, then advanced a random distance that keeps them outside the block zone
+    std::vector<Spear> BlockerSpears(int count, const spear_blocker::Settings& settings) {
+        std::vector<Spear> spears;
+        for (int i = 0; i < count; i++) spear_blocker::SpawnSpear(spears, settings);
+        for (auto& spear : spears) {
+            float travel = static_cast<float>(rand() % (SCREEN_WIDTH / 2 - PLAYER_SIZE * 2));
+            switch (spear.originDirection) {
+                case Direction::UP:    spear.y += travel; break;
+                case Direction::DOWN:  spear.y -= travel; break;
+                case Direction::LEFT:  spear.x += travel; break;
+                case Direction::RIGHT: spear.x -= travel; break;
+                case Direction::NONE:  break;
+            }
+            spear.rect.x = static_cast<int>(spear.x);
+            spear.rect.y = static_cast<int>(spear.y);
+        }
+        return spears;
+    }
+
+    // spears spawned along the edges, kept away from the centred player
+    std::vector<Spear> RunnerSpears(int count, const spear_runner::Settings& settings) {
+        std::vector<Spear> spears;
+        for (int i = 0; i < count; i++) spear_runner::SpawnSpears(spears, settings);
+        for (auto& spear : spears) {
+            if (spear.rect.x > SCREEN_WIDTH / 2 - PLAYER_SIZE && spear.rect.x < SCREEN_WIDTH / 2 + PLAYER_SIZE) spear.rect.x += PLAYER_SIZE * 2;
+            if (spear.rect.y > SCREEN_HEIGHT / 2 - PLAYER_SIZE && spear.rect.y < SCREEN_HEIGHT / 2 + PLAYER_SIZE) spear.rect.y += PLAYER_SIZE * 2;
+            spear.x = static_cast<float>(spear.rect.x);
+            spear.y = static_cast<float>(spear.rect.y);
+        }
+        return spears;
+    }
+
+    void BenchSpearBlocker() {
+        const int BLOCK_ZONE_SIZE = PLAYER_SIZE + 20;
+        SDL_Rect blockZone = {SCREEN_WIDTH / 2 - BLOCK_ZONE_SIZE / 2, SCREEN_HEIGHT / 2 - BLOCK_ZONE_SIZE / 2, BLOCK_ZONE_SIZE, BLOCK_ZONE_SIZE};
+
+        for (int difficulty = 0; difficulty < 3; difficulty++) {
+            spear_blocker::Settings settings = spear_blocker::GetSettingsForDifficulty(static_cast<spear_blocker::Difficulty>(difficulty));
+            for (int count : SPEAR_COUNTS) {
+                std::vector<Spear> initial = BlockerSpears(count, settings);
+                std::vector<std::vector<Spear>> batch(BATCH);
+                Player player = CenteredPlayer();
+                bool gameOver = false;
+
+                RunBench("spear_blocker::UpdateGame", Params(count, difficulty),
+                    [&] { for (auto& spears : batch) spears = initial; gameOver = false; },
+                    [&](int i) { spear_blocker::UpdateGame(player, batch[i], gameOver, blockZone, settings); });
+
+                // one spear per call, cycling through the set, so the result is per check like every other case
+                volatile int inZone = 0;
+                RunBench("spear_blocker::CheckSpearInBlockZone", Params(count, difficulty),
+                    [] {},
+                    [&](int i) { inZone += spear_blocker::CheckSpearInBlockZone(initial[i % initial.size()], blockZone); });
+
+                // one spawn per call on top of count - 1 live spears, capacity reserved as in the game
+                for (auto& spears : batch) spears.reserve(MAX_SPEARS);
+                RunBench("spear_blocker::SpawnSpear", Params(count, difficulty),
+                    [&] { for (auto& spears : batch) spears.assign(initial.begin(), initial.end() - 1); },
+                    [&](int i) { spear_blocker::SpawnSpear(batch[i], settings); });
+            }
+        }
+    }
+
+    void BenchSpearRunner() {
+        for (int difficulty = 0; difficulty < 3; difficulty++) {
+            spear_runner::Settings settings = spear_runner::GetSettingsForDifficulty(static_cast<spear_runner::Difficulty>(difficulty));
+            for (int count : SPEAR_COUNTS) {
+                std::vector<Spear> initial = RunnerSpears(count, settings);
+                std::vector<std::vector<Spear>> batch(BATCH);
+                Player player = CenteredPlayer();
+                spear_runner::GameState gameState = spear_runner::GameState::PLAYING;
+                bool gameOver = false;
+                int frameCount = 0;
+
+                RunBench("spear_runner::UpdateGame", Params(count, difficulty),
+                    [&] { for (auto& spears : batch) spears = initial; player = CenteredPlayer(); gameOver = false; frameCount = 0; },
+                    [&](int i) { spear_runner::UpdateGame(player, batch[i], gameOver, settings, gameState, frameCount, 0.0f, 0.0f); });
+            }
+        }
+    }
+
+    void BenchRendering(SDL_Renderer* renderer, TTF_Font* font) {
+        auto flush = [renderer] { SDL_RenderFlush(renderer); };
+        auto clear = [renderer] { SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); SDL_RenderClear(renderer); SDL_RenderFlush(renderer); };
+
+        for (int radius : {2, 10, 12}) {
+            std::string params = "radius=" + std::to_string(radius);
+            RunBench("FillCircle", params, clear, [&](int i) { FillCircle(renderer, 100 + i, 100, radius); }, flush);
+            RunBench("DrawCircle", params, clear, [&](int i) { DrawCircle(renderer, 100 + i, 100, radius); }, flush);
+        }
+
+        Player player = CenteredPlayer();
+        RunBench("RenderPlayerCharacter", "game=runner", clear, [&](int) { RenderPlayerCharacter(renderer, player, false, 0); }, flush);
+        RunBench("RenderPlayerCharacter", "game=blocker", clear, [&](int) { RenderPlayerCharacter(renderer, player, false, 1); }, flush);
+
+        for (int difficulty = 0; difficulty < 3; difficulty++) {
+            spear_blocker::Settings settings = spear_blocker::GetSettingsForDifficulty(static_cast<spear_blocker::Difficulty>(difficulty));
+            for (int count : SPEAR_COUNTS) {
+                std::vector<Spear> spears = BlockerSpears(count, settings);
+                // one spear per call, cycling through the set
+                RunBench("RenderSpear", Params(count, difficulty), clear,
+                    [&](int i) { RenderSpear(renderer, spears[i % spears.size()]); }, flush);
+            }
+        }
+
+        // a whole world frame on each backend; sw includes clearing, the upload and the copy
+        Player blocker = CenteredPlayer();
+        spear_blocker::Settings hard = spear_blocker::GetSettingsForDifficulty(spear_blocker::Difficulty::HARD);
+        for (int count : SPEAR_COUNTS) {
+            std::vector<Spear> spears = BlockerSpears(count, hard);
+            auto world = [&](int) {
+                RenderPlayerCharacter(renderer, blocker, false, 1);
+                SDL_SetRenderDrawColor(renderer, 0, 180, 255, 255);
+                for (const auto& spear : spears) RenderSpear(renderer, spear);
+            };
+            RunBench("World frame", "backend=sdl spears=" + std::to_string(count), clear,
+                [&](int i) { SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); SDL_RenderClear(renderer); world(i); }, flush);
+            if (!softraster::Enabled()) continue;
+            RunBench("World frame", "backend=sw spears=" + std::to_string(count), clear,
+                [&](int i) { softraster::BeginFrame(renderer); world(i); softraster::EndFrame(renderer); }, flush);
+        }
+
+        SDL_Color white = {255, 255, 255, 255};
+        RunBench("RenderText", "text=\"Score: 1234\"", clear,
+            [&](int) { RenderText(renderer, font, "Score: 1234", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2, white); }, flush);
+        RunBench("RenderScore", "score=1234", clear, [&](int) { RenderScore(renderer, font, 1234); }, flush);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--reps") && i + 1 < argc) options.reps = std::max(1, atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--warmup") && i + 1 < argc) options.warmup = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--filter") && i + 1 < argc) options.filter = argv[++i];
+        else if (!strcmp(argv[i], "--json") && i + 1 < argc) options.jsonPath = argv[++i];
+        else {
+            std::cerr << "usage: " << argv[0] << " [--reps N] [--warmup N] [--filter substring] [--json path]\n";
+            return 1;
+        }
+    }
+
+    if (TTF_Init() == -1) {
+        std::cerr << "Failed to initialize TTF: " << TTF_GetError() << "\n";
+        return 1;
+    }
+    // software renderer on an offscreen surface: no window or GPU needed
+    SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, SCREEN_WIDTH, SCREEN_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer* renderer = target ? SDL_CreateSoftwareRenderer(target) : nullptr;
+    TTF_Font* font = resources::AcquireFont(FONT_PATH, 28);
+    if (!renderer || !font) {
+        std::cerr << "Error creating software renderer or font: " << SDL_GetError() << "\n";
+        return 1;
+    }
+
+    softraster::InitSoftRaster(renderer);
+    srand(1234);    // same spear layout on every run
+    BenchSpearBlocker();
+    BenchSpearRunner();
+    BenchRendering(renderer, font);
+
+    if (!options.jsonPath.empty()) {
+        WriteJson(options.jsonPath);
+        std::cout << "Wrote " << results.size() << " results to " << options.jsonPath << "\n";
+    }
+
+    softraster::ShutdownSoftRaster();
+    resources::ReleaseFont(font);
+    resources::ShutdownResources();
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(target);
+    TTF_Quit();
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,230 @@
+#include "capture.h"
+#include "alloc_tracker.h"
+#include "governor.h"
+#include "input.h"
+#include "logger.h"
+#include "options.h"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace {
+    const uint32_t CAPTURE_BUFFERS = 4;     // frames that can wait for the encoder, power of two
+    const int IDLE_SLEEP_MS = 2;
+
+    // QOI ops, see qoiformat.org
+    const uint8_t QOI_OP_INDEX = 0x00;
+    const uint8_t QOI_OP_DIFF = 0x40;
+    const uint8_t QOI_OP_LUMA = 0x80;
+    const uint8_t QOI_OP_RUN = 0xc0;
+    const uint8_t QOI_OP_RGB = 0xfe;
+    const int QOI_HEADER_BYTES = 14;
+    const uint8_t QOI_END[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+
+    // single producer (render thread), single consumer (encoder thread)
+    uint8_t* buffers[CAPTURE_BUFFERS] = {};
+    std::atomic<uint32_t> head(0);          // next frame to encode
+    std::atomic<uint32_t> tail(0);          // next free buffer
+    int width = 0, height = 0;
+
+    uint8_t* encoded = nullptr;             // worst case QOI frame, owned by the encoder
+    FILE* file = nullptr;
+
+    std::thread encoder_thread;
+    std::atomic<bool> encoder_running(false);
+    bool active = false;
+
+    // render thread
+    capture::CaptureStats stats = {};
+    uint64_t frame_index = 0;
+    // encoder thread
+    std::atomic<uint64_t> frames_encoded(0);
+    std::atomic<uint64_t> bytes_written(0);
+
+    void Put32(uint8_t*& out, uint32_t value) {
+        *out++ = value >> 24;
+        *out++ = value >> 16;
+        *out++ = value >> 8;
+        *out++ = value;
+    }
+
+    // rgba in, opaque 3-channel QOI out; returns the encoded size
+    size_t EncodeQoi(const uint8_t* pixels, uint8_t* out) {
+        uint8_t* start = out;
+        *out++ = 'q'; *out++ = 'o'; *out++ = 'i'; *out++ = 'f';
+        Put32(out, width);
+        Put32(out, height);
+        *out++ = 3;     // channels
+        *out++ = 0;     // sRGB
+
+        uint32_t index[64] = {};
+        uint8_t pr = 0, pg = 0, pb = 0;
+        int run = 0;
+        size_t count = static_cast<size_t>(width) * height;
+        for (size_t i = 0; i < count; i++) {
+            uint8_t r = pixels[i * 4], g = pixels[i * 4 + 1], b = pixels[i * 4 + 2];
+            if (r == pr && g == pg && b == pb) {
+                if (++run == 62) {
+                    *out++ = QOI_OP_RUN | (run - 1);
+                    run = 0;
+                }
+                continue;
+            }
+            if (run > 0) {
+                *out++ = QOI_OP_RUN | (run - 1);
+                run = 0;
+            }
+
+            uint32_t packed = r << 24 | g << 16 | b << 8 | 0xff;
+            int slot = (r * 3 + g * 5 + b * 7 + 255 * 11) % 64;
+            if (index[slot] == packed) {
+                *out++ = QOI_OP_INDEX | slot;
+            }
+            else {
+                index[slot] = packed;
+                int8_t vr = r - pr, vg = g - pg, vb = b - pb;
+                int8_t vgr = vr - vg, vgb = vb - vg;
+                if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+                    *out++ = QOI_OP_DIFF | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2);
+                }
+                else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8) {
+                    *out++ = QOI_OP_LUMA | (vg + 32);
+                    *out++ = (vgr + 8) << 4 | (vgb + 8);
+                }
+                else {
+                    *out++ = QOI_OP_RGB;
+                    *out++ = r;
+                    *out++ = g;
+                    *out++ = b;
+                }
+            }
+            pr = r;
+            pg = g;
+            pb = b;
+        }
+        if (run > 0) *out++ = QOI_OP_RUN | (run - 1);
+        memcpy(out, QOI_END, sizeof(QOI_END));
+        out += sizeof(QOI_END);
+        return out - start;
+    }
+
+    // encode and write every queued frame; returns the number handled
+    int Drain() {
+        int count = 0;
+        uint32_t next = head.load(std::memory_order_relaxed);
+        uint32_t last = tail.load(std::memory_order_acquire);
+        for (; next != last; next++) {
+            size_t size = EncodeQoi(buffers[next % CAPTURE_BUFFERS], encoded);
+            // the buffer can be refilled as soon as it is encoded, before the write
+            head.store(next + 1, std::memory_order_release);
+            if (file && fwrite(encoded, 1, size, file) != size) {
+                logger::Error("Capture write failed (%s), recording stopped", strerror(errno));
+                fclose(file);
+                file = nullptr;
+            }
+            if (file) bytes_written.fetch_add(size, std::memory_order_relaxed);
+            frames_encoded.fetch_add(1, std::memory_order_relaxed);
+            count++;
+        }
+        return count;
+    }
+
+    void EncoderLoop() {
+        alloc_tracker::NameThread("capture");
+        while (encoder_running.load()) {
+            if (Drain() == 0) std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_SLEEP_MS));
+        }
+        Drain();
+    }
+}
+
+namespace capture {
+    bool InitCapture(SDL_Renderer* renderer) {
+        if (!options.capturePath) return true;
+        if (SDL_GetRendererOutputSize(renderer, &width, &height) != 0) {
+            logger::Error("Capture disabled, no renderer output size: %s", SDL_GetError());
+            return false;
+        }
+        file = fopen(options.capturePath, "wb");
+        if (!file) {
+            logger::Error("Could not open capture file %s: %s", options.capturePath, strerror(errno));
+            return false;
+        }
+
+        // all memory up front, so a captured frame never touches the heap
+        size_t frameBytes = static_cast<size_t>(width) * height * 4;
+        for (uint8_t*& buffer : buffers) buffer = new uint8_t[frameBytes];
+        // every pixel as QOI_OP_RGB is the worst case
+        encoded = new uint8_t[QOI_HEADER_BYTES + static_cast<size_t>(width) * height * 4 + sizeof(QOI_END)];
+
+        encoder_running = true;
+        encoder_thread = std::thread(EncoderLoop);
+        active = true;
+        logger::Info("Capturing %dx%d every %d frame(s) to %s", width, height, options.captureEvery, options.capturePath);
+        return true;
+    }
+
+    void PresentFrame(SDL_Renderer* renderer) {
+        // every frame is presented here, so this is where its own work ends
+        governor::FrameSubmitted();
+        if (!active) {
+            SDL_RenderPresent(renderer);
+            return;
+        }
+
+        // readback has to happen before present, the back buffer is undefined afterwards
+        Uint64 start = input::NowUs();
+        stats.frames++;
+        if (frame_index++ % options.captureEvery == 0) {
+            uint32_t next = tail.load(std::memory_order_relaxed);
+            if (next - head.load(std::memory_order_acquire) >= CAPTURE_BUFFERS) {
+                stats.dropped++;
+            }
+            else if (SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_RGBA32, buffers[next % CAPTURE_BUFFERS], width * 4) == 0) {
+                tail.store(next + 1, std::memory_order_release);
+                stats.captured++;
+            }
+            else {
+                stats.dropped++;
+            }
+        }
+        Uint64 cost = input::NowUs() - start;
+        stats.totalCostUs += cost;
+        if (cost > stats.maxCostUs) stats.maxCostUs = cost;
+
+        SDL_RenderPresent(renderer);
+    }
+
+    void ShutdownCapture() {
+        if (!active) return;
+        active = false;
+        if (encoder_running.exchange(false) && encoder_thread.joinable()) encoder_thread.join();
+        if (file) fclose(file);
+        file = nullptr;
+        for (uint8_t*& buffer : buffers) {
+            delete[] buffer;
+            buffer = nullptr;
+        }
+        delete[] encoded;
+        encoded = nullptr;
+    }
+
+    CaptureStats GetCaptureStats() {
+        CaptureStats result = stats;
+        result.encoded = frames_encoded.load(std::memory_order_relaxed);
+        result.bytesWritten = bytes_written.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    void PrintCaptureStats() {
+        if (!options.capturePath) return;
+        CaptureStats s = GetCaptureStats();
+        logger::Info("Capture: %u frames captured, %u dropped (encoder behind), %u encoded, %u KB written",
+                     s.captured, s.dropped, s.encoded, s.bytesWritten / 1024);
+        if (s.frames == 0) return;
+        logger::Info("Capture cost per frame: avg %.1f us, worst %u us", static_cast<double>(s.totalCostUs) / s.frames, s.maxCostUs);
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <SDL2/SDL.h>
+#include <stdint.h>
+
+// optional gameplay recording (--capture FILE): presented frames are read back into a ring of
+// preallocated buffers and a worker thread QOI-encodes them and appends them to FILE
+// when every buffer is still waiting for the encoder the frame is dropped and counted, the
+// render thread never waits for it
+namespace capture {
+    struct CaptureStats {
+        uint64_t frames;        // presents while capturing, including skipped and dropped ones
+        uint64_t captured;      // read back and queued for the encoder
+        uint64_t dropped;       // no free buffer, the encoder was behind
+        uint64_t encoded;
+        uint64_t bytesWritten;
+        uint64_t totalCostUs;   // time PresentFrame added to the render thread, over all frames
+        uint64_t maxCostUs;
+    };
+
+    // allocates the buffers and starts the worker; does nothing without --capture
+    // call before realtime::InitRealtime so the encoder does not inherit the render thread's core
+    bool InitCapture(SDL_Renderer* renderer);
+    // use in place of SDL_RenderPresent
+    void PresentFrame(SDL_Renderer* renderer);
+    // encodes whatever is still queued, then closes the file
+    void ShutdownCapture();
+
+    CaptureStats GetCaptureStats();
+    void PrintCaptureStats();
+}
+
+#endif
@@ -0,0 +1,101 @@
+#include "clocksync.h"
+#include <algorithm>
+
+ClockSync::ClockSync() {
+    Reset();
+    resets = 0;
+}
+
+void ClockSync::Reset() {
+    windowCount = windowHead = 0;
+    windowStartUs = windowMin = windowMinLocal = 0;
+    referenceUs = referenceDelta = 0;
+    slope = intercept = 0;
+    fitted = false;
+    lastBaseline = 0;
+    samples = 0;
+    resets++;
+}
+
+// least squares line through the window minima, relative to the oldest one
+void ClockSync::Refit() {
+    if (windowCount < 2) {
+        fitted = false;
+        return;
+    }
+    const Window& oldest = windows[(windowHead - windowCount + WINDOWS) % WINDOWS];
+    referenceUs = oldest.localUs;
+    referenceDelta = oldest.minDelta;
+
+    double sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+    for (int i = 0; i < windowCount; i++) {
+        const Window& w = windows[(windowHead - windowCount + i + WINDOWS) % WINDOWS];
+        double x = static_cast<double>(w.localUs - referenceUs);
+        double y = static_cast<double>(w.minDelta - referenceDelta);
+        sumX += x; sumY += y; sumXX += x * x; sumXY += x * y;
+    }
+    double n = windowCount;
+    double denominator = n * sumXX - sumX * sumX;
+    if (denominator <= 0) {
+        fitted = false;
+        return;
+    }
+    slope = (n * sumXY - sumX * sumY) / denominator;
+    intercept = (sumY - slope * sumX) / n;
+    fitted = true;
+}
+
+int64_t ClockSync::Baseline(int64_t localUs) const {
+    int64_t baseline = windowMin;
+    if (fitted) {
+        double x = static_cast<double>(localUs - referenceUs);
+        baseline = referenceDelta + static_cast<int64_t>(intercept + slope * x);
+    }
+    else {
+        for (int i = 0; i < windowCount; i++) baseline = std::min(baseline, windows[i].minDelta);
+    }
+    // a new low in the current window wins over the extrapolated line
+    return std::min(baseline, windowMin);
+}
+
+int64_t ClockSync::AddSample(int64_t producerUs, int64_t localUs) {
+    int64_t delta = localUs - producerUs;
+    if (samples > 0 && (delta - lastBaseline > RESET_US || lastBaseline - delta > RESET_US)) Reset();
+
+    if (samples == 0) {
+        windowStartUs = windowMinLocal = localUs;
+        windowMin = delta;
+    }
+    else if (localUs - windowStartUs >= WINDOW_US) {
+        windows[windowHead] = {windowMinLocal, windowMin};
+        windowHead = (windowHead + 1) % WINDOWS;
+        windowCount = std::min(windowCount + 1, WINDOWS);
+        Refit();
+        windowStartUs = windowMinLocal = localUs;
+        windowMin = delta;
+    }
+    else if (delta < windowMin) {
+        windowMin = delta;
+        windowMinLocal = localUs;
+    }
+    samples++;
+
+    lastBaseline = Baseline(localUs);
+    return std::max<int64_t>(0, delta - lastBaseline);
+}
+
+JitterMonitor::JitterMonitor() : mean(0), deviation(0), samples(0), spikes(0) {}
+
+bool JitterMonitor::Update(int64_t latencyUs) {
+    double latency = static_cast<double>(latencyUs);
+    bool spike = samples >= WARMUP && latency - mean > MIN_SPIKE_US && latency > mean + 6 * deviation;
+    if (spike) spikes++;
+
+    // EWMA of mean and mean absolute deviation, like TCP's RTT estimator
+    if (samples == 0) mean = latency;
+    double error = latency - mean;
+    mean += error / 16;
+    deviation += ((error < 0 ? -error : error) - deviation) / 8;
+    samples++;
+    return spike;
+}
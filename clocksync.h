@@ -0,0 +1,65 @@
+#ifndef CLOCKSYNC_H
+#define CLOCKSYNC_H
+
+#include <stdint.h>
+
+// estimates the offset and drift between a producer clock and the local clock from one-way
+// timestamps, NTP-style: the minimum (local - producer) per window is the sample with the least
+// queueing, and a line fitted through recent minima tracks the drift between the two clocks
+class ClockSync {
+public:
+    ClockSync();
+
+    // add one (producer, local) pair, both in microseconds on their own clocks;
+    // returns the delay of this sample above the best-case path
+    int64_t AddSample(int64_t producerUs, int64_t localUs);
+
+    double DriftPpm() const { return slope * 1e6; }
+    int64_t OffsetUs() const { return lastBaseline; }   // local - producer, including the best-case delay
+    int Samples() const { return samples; }
+    int Resets() const { return resets; }
+
+private:
+    static constexpr int WINDOWS = 16;
+    static constexpr int64_t WINDOW_US = 5000000;   // one minimum per 5 s
+    static constexpr int64_t RESET_US = 10000000;   // a jump this large means the producer rebooted
+
+    struct Window {
+        int64_t localUs;
+        int64_t minDelta;
+    };
+
+    void Reset();
+    void Refit();
+    int64_t Baseline(int64_t localUs) const;
+
+    Window windows[WINDOWS];
+    int windowCount, windowHead;
+    int64_t windowStartUs, windowMin, windowMinLocal;
+    int64_t referenceUs, referenceDelta;    // origin of the fitted line, keeps doubles small
+    double slope, intercept;
+    bool fitted;
+    int64_t lastBaseline;
+    int samples, resets;
+};
+
+// flags latency samples far above the recent average
+class JitterMonitor {
+public:
+    JitterMonitor();
+
+    // returns true if this sample is a spike
+    bool Update(int64_t latencyUs);
+
+    int64_t AverageUs() const { return static_cast<int64_t>(mean); }
+    int Spikes() const { return spikes; }
+
+private:
+    static constexpr int WARMUP = 20;
+    static constexpr int64_t MIN_SPIKE_US = 5000;   // ignore spikes smaller than this, whatever the deviation
+
+    double mean, deviation;
+    int samples, spikes;
+};
+
+#endif
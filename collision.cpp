@@ -0,0 +1,59 @@
+#include "collision.h"
+#include <limits>
+
+namespace {
+    const float INF = std::numeric_limits<float>::infinity();
+
+    // the times at which a moving coordinate is inside an interval, each end open or closed
+    struct Window {
+        float start, end;
+        bool startOpen, endOpen;
+    };
+
+    // p + d * t inside the interval lo..hi
+    Window AxisWindow(float p, float d, float lo, float hi, bool loOpen, bool hiOpen) {
+        if (d == 0) {
+            bool inside = (loOpen ? p > lo : p >= lo) && (hiOpen ? p < hi : p <= hi);
+            return inside ? Window{-INF, INF, false, false} : Window{1, 0, false, false};
+        }
+        if (d > 0) return {(lo - p) / d, (hi - p) / d, loOpen, hiOpen};
+        return {(hi - p) / d, (lo - p) / d, hiOpen, loOpen};
+    }
+
+    Window Overlap(const Window& a, const Window& b) {
+        Window result;
+        if (a.start == b.start) result = {a.start, 0, a.startOpen || b.startOpen, false};
+        else result = a.start > b.start ? Window{a.start, 0, a.startOpen, false} : Window{b.start, 0, b.startOpen, false};
+        if (a.end == b.end) { result.end = a.end; result.endOpen = a.endOpen || b.endOpen; }
+        else if (a.end < b.end) { result.end = a.end; result.endOpen = a.endOpen; }
+        else { result.end = b.end; result.endOpen = b.endOpen; }
+        return result;
+    }
+
+    // earliest time within the tick that is in both axis windows
+    bool FirstContact(const Window& x, const Window& y, float& toi) {
+        Window hit = Overlap(Overlap(x, y), {0, 1, false, false});
+        bool empty = hit.start > hit.end || (hit.start == hit.end && (hit.startOpen || hit.endOpen));
+        if (empty) return false;
+        toi = hit.start;
+        return true;
+    }
+}
+
+namespace collision {
+    bool SweepPoint(float x0, float y0, float x1, float y1, const SDL_Rect& rect, float& toi) {
+        Window x = AxisWindow(x0, x1 - x0, rect.x, rect.x + rect.w, false, true);
+        Window y = AxisWindow(y0, y1 - y0, rect.y, rect.y + rect.h, false, true);
+        return FirstContact(x, y, toi);
+    }
+
+    // relative to b, a's corner sweeps b grown by a's size (the Minkowski sum)
+    bool SweepRects(const SDL_Rect& a0, const SDL_Rect& a1, const SDL_Rect& b0, const SDL_Rect& b1, float& toi) {
+        float px = static_cast<float>(a0.x - b0.x), py = static_cast<float>(a0.y - b0.y);
+        float dx = static_cast<float>((a1.x - a0.x) - (b1.x - b0.x));
+        float dy = static_cast<float>((a1.y - a0.y) - (b1.y - b0.y));
+        Window x = AxisWindow(px, dx, -a1.w, b1.w, true, true);
+        Window y = AxisWindow(py, dy, -a1.h, b1.h, true, true);
+        return FirstContact(x, y, toi);
+    }
+}
@@ -0,0 +1,19 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <SDL2/SDL.h>
+
+// swept tests for things that move in straight lines over one simulation tick, so a spear
+// that moves further than the target is wide in one tick still hits it; toi is the time of
+// impact as a fraction of the tick, 0 = where it started and 1 = where it ended up
+namespace collision {
+    // a point moving from (x0, y0) to (x1, y1) against rect, inside meaning
+    // [x, x + w) x [y, y + h) like the spear tip test
+    bool SweepPoint(float x0, float y0, float x1, float y1, const SDL_Rect& rect, float& toi);
+
+    // a moving from a0 to a1 while b moves from b0 to b1; touching edges do not count,
+    // like SDL_HasIntersection
+    bool SweepRects(const SDL_Rect& a0, const SDL_Rect& a1, const SDL_Rect& b0, const SDL_Rect& b1, float& toi);
+}
+
+#endif
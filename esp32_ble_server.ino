@@ -50,8 +50,9 @@ int old_x_cmd = NEUTRAL, old_y_cmd = NEUTRAL, old_btn_val = RELEASED;
 int new_x_cmd = NEUTRAL, new_y_cmd = NEUTRAL, new_btn_val = RELEASED;
 // true to trigger first update
 bool x_cmd_changed = true, y_cmd_changed = true, btn_val_changed = true;
-// for setting/writing to BLE characteristics
-char x_cmd_str[4], y_cmd_str[4], btn_val_str[4];
+// for setting/writing to BLE characteristics: "<value> <send time in ms>"
+// the send time lets the game estimate clock offset/drift and per-event latency live
+char x_cmd_str[24], y_cmd_str[24], btn_val_str[24];
 
 BLEServer *pServer = NULL;
 BLECharacteristic *pCharacteristicX = NULL;
@@ -189,7 +190,7 @@ void loop() {
         // case RIGHT: Serial.print("x_cmd = right \n"); break;
         // default: Serial.print("x_cmd = neutral \n");
       }
-      sprintf(x_cmd_str, "%d", new_x_cmd);
+      sprintf(x_cmd_str, "%d %lu", new_x_cmd, millis());
       pCharacteristicX->setValue(x_cmd_str);
       // notify client
       pCharacteristicX->notify();
@@ -208,7 +209,7 @@ void loop() {
         // case DOWN: Serial.print("y_cmd = down\n"); break;
         // default: Serial.print("y_cmd = neutral\n");
       }
-      sprintf(y_cmd_str, "%d", new_y_cmd);
+      sprintf(y_cmd_str, "%d %lu", new_y_cmd, millis());
       pCharacteristicY->setValue(y_cmd_str);
       pCharacteristicY->notify();
 
@@ -222,7 +223,7 @@ void loop() {
     if (btn_val_changed) {
       old_btn_val = new_btn_val;
       // if (!new_btn_val) Serial.print("btn_val = pressed\n");
-      sprintf(btn_val_str, "%d", new_btn_val);
+      sprintf(btn_val_str, "%d %lu", new_btn_val, millis());
       pCharacteristicBtn->setValue(btn_val_str);
       pCharacteristicBtn->notify();
 
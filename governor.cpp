@@ -0,0 +1,95 @@
+#include "governor.h"
+#include "input.h"
+#include "logger.h"
+#include "menu.h"
+#include "options.h"
+#include <algorithm>
+
+namespace {
+    // fractions of the frame budget, the present interval (FrameBudgetSeconds)
+    const double LONG_FRAME = 1.25;                 // a frame this long missed its vsync
+    const double HEADROOM = 0.5;                    // every frame's own work under this allows a step up
+    const int WINDOW_FRAMES = 30;
+    const int LONG_FRAMES_TO_STEP = 3;              // long frames per window that step the level down
+    const int COOLDOWN_WINDOWS = 4;                 // windows to hold a level after stepping down
+
+    governor::Level level = governor::Level::FULL;
+    governor::GovernorStats stats = {};
+
+    // render thread only
+    Uint64 frame_start_us = 0;
+    double work_seconds = 0;        // printFPS to FrameSubmitted of the previous frame
+    int window_frames = 0;
+    int long_frames = 0;
+    double max_work = 0;
+    int cooldown = 0;
+
+    const char* LevelName(governor::Level value) {
+        static const char* names[] = {"full", "no outlines", "sprites", "throttled hud"};
+        return names[static_cast<int>(value)];
+    }
+
+    void SetLevel(governor::Level next) {
+        if (next > level) {
+            logger::Info("Governor: %s -> %s, %d long frames", LevelName(level), LevelName(next), long_frames);
+            stats.stepsDown++;
+        }
+        else logger::Info("Governor: %s -> %s, frame work under %.2f ms", LevelName(level), LevelName(next), max_work * 1000.0);
+        level = next;
+        stats.transitions++;
+    }
+}
+
+namespace governor {
+    void UpdateGovernor(double frameSeconds) {
+        frame_start_us = input::NowUs();
+        stats.framesAtLevel[static_cast<int>(level)]++;
+        if (!options.governor) return;
+
+        double budget = FrameBudgetSeconds();
+        if (frameSeconds > budget * LONG_FRAME) long_frames++;
+        max_work = std::max(max_work, work_seconds);
+        if (++window_frames < WINDOW_FRAMES) return;
+
+        int current = static_cast<int>(level);
+        if (long_frames >= LONG_FRAMES_TO_STEP && current < static_cast<int>(Level::COUNT) - 1) {
+            SetLevel(static_cast<Level>(current + 1));
+            cooldown = COOLDOWN_WINDOWS;
+        }
+        else if (cooldown > 0) {
+            cooldown--;
+        }
+        else if (long_frames == 0 && max_work < budget * HEADROOM && current > 0) {
+            SetLevel(static_cast<Level>(current - 1));
+        }
+        window_frames = 0;
+        long_frames = 0;
+        max_work = 0;
+    }
+
+    void FrameSubmitted() {
+        if (frame_start_us) work_seconds = (input::NowUs() - frame_start_us) / 1e6;
+    }
+
+    double FrameWorkSeconds() {
+        return work_seconds;
+    }
+
+    Level CurrentLevel() {
+        return level;
+    }
+
+    GovernorStats GetGovernorStats() {
+        GovernorStats result = stats;
+        result.level = level;
+        return result;
+    }
+
+    void PrintGovernorStats() {
+        if (!options.governor) return;
+        logger::Info("Governor: %u transitions (%u down), ending at %s", stats.transitions, stats.stepsDown, LevelName(level));
+        for (int i = 0; i < static_cast<int>(Level::COUNT); i++) {
+            if (stats.framesAtLevel[i]) logger::Info("  %s: %u frames", LevelName(static_cast<Level>(i)), stats.framesAtLevel[i]);
+        }
+    }
+}
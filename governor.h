@@ -0,0 +1,41 @@
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+#include <stdint.h>
+
+// frame-budget governor: watches frame times against the present interval (FrameBudgetSeconds)
+// and trades render detail for time when frames run long, one level at a time, stepping back
+// up once there is headroom
+// disabled with --no-governor
+namespace governor {
+    enum class Level {
+        FULL,
+        NO_OUTLINES,    // circle outlines of heads and shields are skipped
+        SPRITES,        // heads and shields are cached sprites, eyes plain rects
+        THROTTLED_HUD,  // score text is redrawn a few times a second and reused in between
+        COUNT
+    };
+
+    struct GovernorStats {
+        Level level;
+        uint64_t transitions;
+        uint64_t stepsDown;
+        uint64_t framesAtLevel[static_cast<int>(Level::COUNT)];
+    };
+
+    // once per frame from printFPS with the full frame time, including vsync and FrameDelay
+    void UpdateGovernor(double frameSeconds);
+    // when the frame is handed to the display; the time since printFPS is the frame's own work,
+    // which shows headroom that the padded frame time hides
+    void FrameSubmitted();
+    // that work for the last frame, in seconds; also used by the auto render scale
+    double FrameWorkSeconds();
+
+    Level CurrentLevel();
+    inline bool AtLeast(Level level) { return CurrentLevel() >= level; }
+
+    GovernorStats GetGovernorStats();
+    void PrintGovernorStats();
+}
+
+#endif
@@ -0,0 +1,611 @@
+#include "input.h"
+#include "alloc_tracker.h"
+#include "clocksync.h"
+#include "logger.h"
+#include "options.h"
+#include "realtime.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <system_error>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+namespace {
+    const int QUEUE_CAPACITY = 64;          // per player
+    const int PUMP_BATCH = 16;
+    const Sint16 AXIS_THRESHOLD = 16000;    // stick deflection that counts as a direction
+    const int KEYBOARD_PLAYERS = 2;         // arrows + enter/space, WASD + left shift
+
+    struct PlayerQueue {
+        input::InputEvent events[QUEUE_CAPACITY];
+        int head, count;
+    };
+
+    std::mutex queue_mutex;
+    PlayerQueue queues[input::MAX_PLAYERS];
+    Joystick current = {NEUTRAL, NEUTRAL, RELEASED};
+    Joystick player_current[input::MAX_PLAYERS];
+    Joystick last_state[static_cast<int>(input::Source::COUNT)][input::MAX_PLAYERS];
+    input::InputStats stats = {};
+    std::atomic<bool> quit_requested(false);
+
+    // held keyboard keys, folded into a joystick state per player
+    struct KeyState {
+        bool left, right, up, down, btn;
+    };
+    KeyState keys[KEYBOARD_PLAYERS] = {};
+
+    struct ControllerState {
+        SDL_GameController* controller;
+        int player;
+        bool left, right, up, down, btn;
+        int axisX, axisY;   // CMD derived from the left stick
+    };
+    std::map<SDL_JoystickID, ControllerState> controllers;
+
+    // one line of a replay script: "<frame> <x> <y> <btn> [player]" or "<frame> quit"
+    struct ReplayStep {
+        int frame;
+        Joystick state;
+        int player;
+        bool quit;
+    };
+    std::vector<ReplayStep> replay;
+    size_t replay_next = 0;
+    int replay_frame = 0;
+
+    // one FIFO written by a Python BLE client; all channels share the reader thread
+    struct Channel {
+        const char* path;
+        int fd;
+        Uint64 retryUs;             // when to try opening again while fd < 0
+        bool waitingLogged;         // "not found" is logged once per outage, not every retry
+        // bytes read that do not form a complete line yet; reused for every line
+        char buffer[256];
+        size_t used;
+        // ESP32 clock against the bridge's wall clock, and spikes in the resulting latency
+        ClockSync clock;
+        JitterMonitor jitter;
+    };
+    Channel channels[MAX_INPUT_CHANNELS];
+    int channel_count = 0;
+
+    std::thread reader_thread;
+    int epoll_fd = -1;
+    int wake_fd = -1;               // eventfd that interrupts epoll_wait at shutdown
+    const Uint64 WAKE_TOKEN = ~0ull;
+
+    Joystick KeyboardJoystick(const KeyState& key) {
+        Joystick state;
+        state.x = key.left ? LEFT : (key.right ? RIGHT : NEUTRAL);
+        state.y = key.up ? UP : (key.down ? DOWN : NEUTRAL);
+        state.btn = key.btn ? PRESSED : RELEASED;
+        return state;
+    }
+
+    Joystick ControllerJoystick(const ControllerState& pad) {
+        Joystick state;
+        state.x = pad.left ? LEFT : (pad.right ? RIGHT : pad.axisX);
+        state.y = pad.up ? UP : (pad.down ? DOWN : pad.axisY);
+        state.btn = pad.btn ? PRESSED : RELEASED;
+        return state;
+    }
+
+    int AxisToCmd(Sint16 value, int negative, int positive) {
+        if (value < -AXIS_THRESHOLD) return negative;
+        if (value > AXIS_THRESHOLD) return positive;
+        return NEUTRAL;
+    }
+
+    // controllers take the lowest player slot no other controller holds
+    int FreeControllerPlayer() {
+        for (int player = 0; player < input::MAX_PLAYERS; player++) {
+            bool taken = false;
+            for (const auto& item : controllers) taken |= item.second.player == player;
+            if (!taken) return player;
+        }
+        return input::MAX_PLAYERS - 1;
+    }
+
+    // SDL timestamps are milliseconds since SDL_Init; rebase them onto NowUs()
+    Uint64 SdlEventUs(Uint32 timestamp) {
+        Uint64 now = input::NowUs();
+        Uint64 age = static_cast<Uint64>(SDL_GetTicks() - timestamp) * 1000;
+        return age < now ? now - age : now;
+    }
+
+    void HandleSdlEvent(const SDL_Event& event) {
+        switch (event.type) {
+            case SDL_QUIT:
+                quit_requested = true;
+                break;
+            case SDL_KEYDOWN:
+            case SDL_KEYUP: {
+                if (event.key.repeat) break;
+                bool down = event.type == SDL_KEYDOWN;
+                int player = 0;
+                switch (event.key.keysym.sym) {
+                    case SDLK_LEFT:   keys[0].left = down; break;
+                    case SDLK_RIGHT:  keys[0].right = down; break;
+                    case SDLK_UP:     keys[0].up = down; break;
+                    case SDLK_DOWN:   keys[0].down = down; break;
+                    case SDLK_RETURN:
+                    case SDLK_SPACE:  keys[0].btn = down; break;
+                    case SDLK_a:      keys[1].left = down; player = 1; break;
+                    case SDLK_d:      keys[1].right = down; player = 1; break;
+                    case SDLK_w:      keys[1].up = down; player = 1; break;
+                    case SDLK_s:      keys[1].down = down; player = 1; break;
+                    case SDLK_LSHIFT: keys[1].btn = down; player = 1; break;
+                    case SDLK_ESCAPE: if (down) quit_requested = true; return;
+                    default: return;
+                }
+                input::PushInputEvent(KeyboardJoystick(keys[player]), input::Source::KEYBOARD, player, SdlEventUs(event.common.timestamp));
+                break;
+            }
+            case SDL_CONTROLLERDEVICEADDED: {
+                SDL_GameController* controller = SDL_GameControllerOpen(event.cdevice.which);
+                if (controller) {
+                    SDL_JoystickID id = SDL_JoystickGetDeviceInstanceID(event.cdevice.which);
+                    int player = FreeControllerPlayer();
+                    controllers[id] = {controller, player, false, false, false, false, false, NEUTRAL, NEUTRAL};
+                    logger::Info("Game controller connected as player %d.", player + 1);
+                }
+                break;
+            }
+            case SDL_CONTROLLERDEVICEREMOVED: {
+                auto it = controllers.find(event.cdevice.which);
+                if (it != controllers.end()) {
+                    SDL_GameControllerClose(it->second.controller);
+                    logger::Info("Game controller for player %d disconnected.", it->second.player + 1);
+                    controllers.erase(it);
+                }
+                break;
+            }
+            case SDL_CONTROLLERBUTTONDOWN:
+            case SDL_CONTROLLERBUTTONUP: {
+                auto it = controllers.find(event.cbutton.which);
+                if (it == controllers.end()) break;
+                bool down = event.type == SDL_CONTROLLERBUTTONDOWN;
+                ControllerState& pad = it->second;
+                switch (event.cbutton.button) {
+                    case SDL_CONTROLLER_BUTTON_DPAD_LEFT:  pad.left = down; break;
+                    case SDL_CONTROLLER_BUTTON_DPAD_RIGHT: pad.right = down; break;
+                    case SDL_CONTROLLER_BUTTON_DPAD_UP:    pad.up = down; break;
+                    case SDL_CONTROLLER_BUTTON_DPAD_DOWN:  pad.down = down; break;
+                    case SDL_CONTROLLER_BUTTON_A:
+                    case SDL_CONTROLLER_BUTTON_START:      pad.btn = down; break;
+                    default: return;
+                }
+                input::PushInputEvent(ControllerJoystick(pad), input::Source::CONTROLLER, pad.player, SdlEventUs(event.common.timestamp));
+                break;
+            }
+            case SDL_CONTROLLERAXISMOTION: {
+                auto it = controllers.find(event.caxis.which);
+                if (it == controllers.end()) break;
+                ControllerState& pad = it->second;
+                if (event.caxis.axis == SDL_CONTROLLER_AXIS_LEFTX) pad.axisX = AxisToCmd(event.caxis.value, LEFT, RIGHT);
+                else if (event.caxis.axis == SDL_CONTROLLER_AXIS_LEFTY) pad.axisY = AxisToCmd(event.caxis.value, UP, DOWN);
+                else break;
+                // most axis motion stays inside one direction and is coalesced away
+                input::PushInputEvent(ControllerJoystick(pad), input::Source::CONTROLLER, pad.player, SdlEventUs(event.common.timestamp));
+                break;
+            }
+        }
+    }
+
+    bool LoadReplay(const char* path) {
+        std::ifstream file(path);
+        if (!file.is_open()) return false;
+        std::string replay_line;
+        while (std::getline(file, replay_line)) {
+            if (replay_line.empty() || replay_line[0] == '#') continue;
+            std::stringstream ss(replay_line);
+            ReplayStep step = {0, {NEUTRAL, NEUTRAL, RELEASED}, 0, false};
+            std::string word;
+            if (!(ss >> step.frame >> word)) continue;
+            if (word == "quit") step.quit = true;
+            else {
+                step.state.x = atoi(word.c_str());
+                if (!(ss >> step.state.y >> step.state.btn)) {
+                    logger::Warn("Could not parse replay line: %s", replay_line);
+                    continue;
+                }
+                // optional player number, 1-based like the on-screen labels
+                if (ss >> step.player) step.player = std::min(std::max(step.player - 1, 0), input::MAX_PLAYERS - 1);
+                else step.player = 0;
+            }
+            replay.push_back(step);
+        }
+        return true;
+    }
+
+    // replay frames are counted in PumpInput calls, so a script is independent of frame rate
+    void PumpReplay() {
+        replay_frame++;
+        while (replay_next < replay.size() && replay[replay_next].frame <= replay_frame) {
+            const ReplayStep& step = replay[replay_next++];
+            if (step.quit) quit_requested = true;
+            else input::PushInputEvent(step.state, input::Source::REPLAY, step.player, input::NowUs());
+        }
+    }
+
+    // stats of one channel; caller holds queue_mutex
+    input::ChannelStats& StatsFor(const Channel& channel) {
+        return stats.channels[&channel - channels];
+    }
+
+    // open the FIFO created by the Python BLE client without waiting for a writer;
+    // on failure the channel is retried from the reader loop
+    void OpenChannel(Channel& channel) {
+        Uint64 now = input::NowUs();
+        // check if the FIFO file exists and is a FIFO before opening
+        struct stat stat_buf;
+        if (stat(channel.path, &stat_buf) == 0) {
+            if (!S_ISFIFO(stat_buf.st_mode)) {
+                logger::Error("%s exists but is not a FIFO.", channel.path);
+                channel.retryUs = now + 5000000;
+                return;
+            }
+        }
+        else {
+            // file doesn't exist yet, wait for Python script to create it
+            if (errno != ENOENT) logger::Error("Error checking FIFO status: %s", strerror(errno));
+            else if (!channel.waitingLogged) logger::Info("FIFO %s not found, waiting...", channel.path);
+            channel.waitingLogged = true;
+            channel.retryUs = now + 2000000;
+            return;
+        }
+
+        // non-blocking, so one missing bridge never holds up the other channels
+        channel.fd = open(channel.path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (channel.fd < 0) {
+            logger::Error("Error opening FIFO: %s. Retrying...", channel.path);
+            channel.retryUs = now + 2000000;
+            return;
+        }
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u64 = static_cast<Uint64>(&channel - channels);
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, channel.fd, &event);
+        channel.waitingLogged = false;
+        logger::Info("Watching FIFO %s for player %d.", channel.path, static_cast<int>(&channel - channels) + 1);
+    }
+
+    void CloseChannel(Channel& channel) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, channel.fd, nullptr);
+        close(channel.fd);
+        channel.fd = -1;
+        channel.used = 0;           // a partial line does not survive the writer
+        channel.retryUs = 0;        // reopen right away for the next writer
+    }
+
+    Sint64 WallClockUs() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // turn the bridge's timestamps into a one-way latency and backdate the event by it
+    void PushTimestampedEvent(Channel& channel, const Joystick& state, Sint64 espMs, Sint64 bridgeUs) {
+        Uint64 now = input::NowUs();
+        Sint64 bridgeLatency = std::max<Sint64>(0, WallClockUs() - bridgeUs);
+        Sint64 espLatency = 0;
+        Sint64 producerUs = -1;
+        if (espMs >= 0) {
+            // the ESP32 clock is unrelated to ours; only the delay above the best case is observable
+            producerUs = espMs * 1000;
+            espLatency = channel.clock.AddSample(producerUs, bridgeUs);
+        }
+        Sint64 latency = bridgeLatency + espLatency;
+        bool spike = channel.jitter.Update(latency);
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            input::ChannelStats& channelStats = StatsFor(channel);
+            channelStats.timestamped++;
+            channelStats.lastLatencyUs = latency;
+            channelStats.lastBridgeLatencyUs = bridgeLatency;
+            channelStats.totalLatencyUs += latency;
+            if (latency > channelStats.maxLatencyUs) channelStats.maxLatencyUs = latency;
+            channelStats.clockDriftPpm = channel.clock.DriftPpm();
+            channelStats.jitterSpikes = channel.jitter.Spikes();
+        }
+        int player = static_cast<int>(&channel - channels);
+        if (spike) {
+            logger::Warn("Input latency spike on player %d: %d us (bridge -> game %d us, average %d us)", player + 1,
+                         latency, bridgeLatency, channel.jitter.AverageUs());
+        }
+        Uint64 sourceUs = static_cast<Uint64>(latency) < now ? now - latency : now;
+        input::PushInputEvent(state, input::Source::FIFO, player, sourceUs, producerUs, bridgeUs);
+    }
+
+    // parse the next integer field of a line; false if there is none
+    bool ParseField(const char*& cursor, long long& value) {
+        char* end;
+        value = strtoll(cursor, &end, 10);
+        if (end == cursor) return false;
+        cursor = end;
+        return true;
+    }
+
+    // process one received line (X Y Button [ESP32 send ms] [bridge receive us]) without allocating
+    void ParseLine(Channel& channel, const char* line) {
+        const char* cursor = line;
+        long long x, y, btn, espMs, bridgeUs;
+        if (!ParseField(cursor, x) || !ParseField(cursor, y) || !ParseField(cursor, btn)) {
+            logger::Warn("Could not parse line from %s: %s", channel.path, line);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            StatsFor(channel).events++;
+            StatsFor(channel).connected = true;
+        }
+        Joystick new_joy = {static_cast<int>(x), static_cast<int>(y), static_cast<int>(btn)};
+        // older bridges send only the state
+        if (ParseField(cursor, espMs) && ParseField(cursor, bridgeUs)) PushTimestampedEvent(channel, new_joy, espMs, bridgeUs);
+        else input::PushInputEvent(new_joy, input::Source::FIFO, static_cast<int>(&channel - channels), input::NowUs());
+    }
+
+    // drain everything the bridge has written; reopens the FIFO when the writer went away
+    void ServiceChannel(Channel& channel) {
+        ssize_t n;
+        for (;;) {
+            n = read(channel.fd, channel.buffer + channel.used, sizeof(channel.buffer) - 1 - channel.used);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            channel.used += n;
+
+            char* start = channel.buffer;
+            char* end = channel.buffer + channel.used;
+            char* newline;
+            while ((newline = static_cast<char*>(memchr(start, '\n', end - start)))) {
+                *newline = '\0';
+                if (newline > start && newline[-1] == '\r') newline[-1] = '\0';
+                ParseLine(channel, start);
+                start = newline + 1;
+            }
+            channel.used = end - start;
+            if (channel.used == sizeof(channel.buffer) - 1) {
+                // no newline in a full buffer; the bridge never sends lines this long
+                channel.buffer[channel.used] = '\0';
+                logger::Warn("Could not parse line from %s: %s", channel.path, channel.buffer);
+                channel.used = 0;
+            }
+            else memmove(channel.buffer, start, channel.used);
+        }
+        if (n < 0 && errno == EAGAIN) return;   // drained, the writer is still there
+
+        // read failed; this could mean the writer closed the pipe (EOF)
+        // or some other error occurred
+        if (n == 0) logger::Info("Writer closed %s (EOF reached). Re-opening...", channel.path);
+        else logger::Error("Error reading %s: %s. Re-opening...", channel.path, strerror(errno));
+        CloseChannel(channel);
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        StatsFor(channel).connected = false;
+        StatsFor(channel).reconnects++;
+        stats.reconnects++;
+    }
+
+    // FIFO sources: one thread watches every channel, however many controllers are attached
+    void ReadChannels() {
+        alloc_tracker::NameThread("fifo");
+        realtime::ConfigureThread(realtime::Role::INPUT);
+        epoll_event events[MAX_INPUT_CHANNELS + 1];
+        while (!quit_requested) {
+            // channels without an open FIFO are retried on a timer
+            Uint64 now = input::NowUs();
+            Uint64 nextRetry = 0;
+            for (int i = 0; i < channel_count; i++) {
+                Channel& channel = channels[i];
+                if (channel.fd >= 0) continue;
+                if (channel.retryUs <= now) OpenChannel(channel);
+                if (channel.fd < 0 && (nextRetry == 0 || channel.retryUs < nextRetry)) nextRetry = channel.retryUs;
+            }
+            int timeoutMs = nextRetry ? static_cast<int>((std::max(nextRetry, now) - now) / 1000) + 1 : -1;
+
+            int count = epoll_wait(epoll_fd, events, MAX_INPUT_CHANNELS + 1, timeoutMs);
+            for (int i = 0; i < count; i++) {
+                if (events[i].data.u64 == WAKE_TOKEN) return;
+                Channel& channel = channels[events[i].data.u64];
+                if (channel.fd >= 0) ServiceChannel(channel);
+            }
+        }
+    }
+
+    void PushQueue(PlayerQueue& queue, const input::InputEvent& event) {
+        if (queue.count == QUEUE_CAPACITY) {
+            // keep the newest input; the game is not draining fast enough
+            queue.head = (queue.head + 1) % QUEUE_CAPACITY;
+            queue.count--;
+            stats.dropped++;
+        }
+        queue.events[(queue.head + queue.count) % QUEUE_CAPACITY] = event;
+        queue.count++;
+    }
+
+    // caller holds queue_mutex
+    void PopQueue(PlayerQueue& queue, input::InputEvent& event) {
+        event = queue.events[queue.head];
+        queue.head = (queue.head + 1) % QUEUE_CAPACITY;
+        queue.count--;
+
+        Uint64 now = input::NowUs();
+        Uint64 latency = now > event.sourceUs ? now - event.sourceUs : 0;
+        input::SourceStats& source = stats.sources[static_cast<int>(event.source)];
+        source.events++;
+        source.totalLatencyUs += latency;
+        if (latency > source.maxLatencyUs) source.maxLatencyUs = latency;
+    }
+}
+
+namespace input {
+    Uint64 NowUs() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void InitInput() {
+        for (auto& player : last_state) {
+            for (auto& state : player) state = {NEUTRAL, NEUTRAL, RELEASED};
+        }
+        for (auto& state : player_current) state = {NEUTRAL, NEUTRAL, RELEASED};
+        // controllers are optional; keyboard and FIFO still work without the subsystem
+        if (SDL_InitSubSystem(SDL_INIT_GAMECONTROLLER) < 0) {
+            logger::Warn("Game controller support unavailable: %s", SDL_GetError());
+        }
+        if (options.replayPath) {
+            if (!LoadReplay(options.replayPath)) {
+                logger::Error("Error opening replay: %s", options.replayPath);
+                quit_requested = true;
+            }
+            return;
+        }
+
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (epoll_fd < 0 || wake_fd < 0) {
+            logger::Error("Error setting up the FIFO reader: %s", strerror(errno));
+            return;
+        }
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u64 = WAKE_TOKEN;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+
+        channel_count = options.fifoCount;
+        stats.channelCount = channel_count;
+        for (int i = 0; i < channel_count; i++) {
+            channels[i].path = options.fifoPaths[i];
+            channels[i].fd = -1;
+        }
+        try {
+            reader_thread = std::thread(ReadChannels);
+        }
+        catch (const std::system_error& error) {
+            // keyboard and controllers still work without the BLE reader
+            logger::Warn("Could not start the FIFO reader (%s), BLE input disabled", error.what());
+            channel_count = 0;
+            stats.channelCount = 0;
+        }
+    }
+
+    void ShutdownInput() {
+        quit_requested = true;
+        for (auto& item : controllers) SDL_GameControllerClose(item.second.controller);
+        controllers.clear();
+        // the reader never blocks outside epoll_wait, so it can be woken and joined
+        if (reader_thread.joinable()) {
+            Uint64 one = 1;
+            if (write(wake_fd, &one, sizeof(one)) < 0) logger::Error("Error waking the FIFO reader: %s", strerror(errno));
+            reader_thread.join();
+        }
+        for (int i = 0; i < channel_count; i++) {
+            if (channels[i].fd >= 0) CloseChannel(channels[i]);
+        }
+        if (wake_fd >= 0) close(wake_fd);
+        if (epoll_fd >= 0) close(epoll_fd);
+        wake_fd = epoll_fd = -1;
+    }
+
+    void PumpInput() {
+        if (!replay.empty()) PumpReplay();
+        SDL_PumpEvents();
+        SDL_Event events[PUMP_BATCH];
+        int count;
+        while ((count = SDL_PeepEvents(events, PUMP_BATCH, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT)) > 0) {
+            for (int i = 0; i < count; i++) HandleSdlEvent(events[i]);
+        }
+    }
+
+    void PushInputEvent(const Joystick& state, Source source, int player, Uint64 sourceUs, Sint64 producerUs, Sint64 bridgeUs) {
+        Uint64 arrival = NowUs();
+        player = std::min(std::max(player, 0), MAX_PLAYERS - 1);
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stats.received++;
+        Joystick& last = last_state[static_cast<int>(source)][player];
+        if (state == last) {
+            stats.coalesced++;
+            return;
+        }
+        last = state;
+        current = state;
+        player_current[player] = state;
+
+        InputEvent event;
+        event.state = state;
+        event.source = source;
+        event.player = player;
+        event.sourceUs = sourceUs;
+        event.arrivalUs = arrival;
+        event.producerUs = producerUs;
+        event.bridgeUs = bridgeUs;
+        PushQueue(queues[player], event);
+    }
+
+    bool PollInputEvent(InputEvent& event) {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        // oldest head across the players, so menus see events in arrival order
+        PlayerQueue* oldest = nullptr;
+        for (auto& queue : queues) {
+            if (queue.count == 0) continue;
+            if (!oldest || queue.events[queue.head].arrivalUs < oldest->events[oldest->head].arrivalUs) oldest = &queue;
+        }
+        if (!oldest) return false;
+        PopQueue(*oldest, event);
+        return true;
+    }
+
+    bool PollPlayerEvent(int player, InputEvent& event) {
+        if (player < 0 || player >= MAX_PLAYERS) return false;
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (queues[player].count == 0) return false;
+        PopQueue(queues[player], event);
+        return true;
+    }
+
+    Joystick CurrentJoystick() {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        return current;
+    }
+
+    Joystick PlayerJoystick(int player) {
+        if (player < 0 || player >= MAX_PLAYERS) return {NEUTRAL, NEUTRAL, RELEASED};
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        return player_current[player];
+    }
+
+    bool QuitRequested() {
+        return quit_requested;
+    }
+
+    InputStats GetInputStats() {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        return stats;
+    }
+
+    void PrintInputStats() {
+        static const char* names[] = {"fifo", "keyboard", "controller", "replay"};
+        InputStats s = GetInputStats();
+        logger::Info("Input: %d received, %d coalesced, %d dropped, %d reconnects", s.received, s.coalesced, s.dropped, s.reconnects);
+        for (int i = 0; i < static_cast<int>(Source::COUNT); i++) {
+            const SourceStats& source = s.sources[i];
+            if (source.events == 0) continue;
+            logger::Info("  %s: %d events, avg latency %u us, max %u us", names[i], source.events,
+                         source.totalLatencyUs / source.events, source.maxLatencyUs);
+        }
+        for (int i = 0; i < s.channelCount; i++) {
+            const ChannelStats& channel = s.channels[i];
+            logger::Info("  player %d fifo %s: %d events, %d reconnects", i + 1, options.fifoPaths[i], channel.events, channel.reconnects);
+            if (channel.timestamped == 0) continue;
+            logger::Info("    latency avg %d us, max %d us, last %d us (bridge -> game %d us)",
+                         static_cast<Sint64>(channel.totalLatencyUs / channel.timestamped), channel.maxLatencyUs,
+                         channel.lastLatencyUs, channel.lastBridgeLatencyUs);
+            logger::Info("    ESP32 clock drift %.2f ppm, %d jitter spikes", channel.clockDriftPpm, channel.jitterSpikes);
+        }
+    }
+}
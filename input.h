@@ -0,0 +1,90 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <SDL2/SDL.h>
+#include "menu.h"
+#include "options.h"
+
+// merges every input device into timestamped per-player event streams
+// sources: SDL keyboard, SDL game controllers and the FIFOs written by the Python BLE client
+// (one channel per controller, all watched by a single epoll reader thread), or a frame-indexed
+// replay script (--replay) in place of the FIFOs
+namespace input {
+    const int MAX_PLAYERS = MAX_INPUT_CHANNELS;
+
+    enum class Source {
+        FIFO,
+        KEYBOARD,
+        CONTROLLER,
+        REPLAY,
+        COUNT
+    };
+
+    struct InputEvent {
+        Joystick state;     // complete joystick state after this event
+        Source source;
+        int player;         // FIFO channel / controller / keyboard half this came from
+        Uint64 sourceUs;    // when the device produced the event, on the NowUs() clock
+        Uint64 arrivalUs;   // when it entered the merged stream
+        // raw producer timestamps forwarded by the BLE bridge, -1 when the source has none
+        Sint64 producerUs;  // ESP32 send time, on the ESP32 clock
+        Sint64 bridgeUs;    // bridge receive time, on the wall clock
+    };
+
+    struct SourceStats {
+        int events;
+        Uint64 totalLatencyUs;  // source timestamp -> dequeued by the game
+        Uint64 maxLatencyUs;
+    };
+
+    // one FIFO channel, i.e. one BLE controller and its bridge
+    struct ChannelStats {
+        bool connected;     // a bridge has written since the FIFO was last opened
+        int events;         // lines parsed
+        int reconnects;     // FIFO reopened after the writer went away
+        // live one-way latency of timestamped events (ESP32 -> bridge -> game)
+        int timestamped;
+        Sint64 lastLatencyUs;
+        Sint64 lastBridgeLatencyUs; // bridge -> game part, exact since both share the wall clock
+        Sint64 maxLatencyUs;
+        Uint64 totalLatencyUs;
+        double clockDriftPpm;       // ESP32 clock against the bridge clock
+        int jitterSpikes;
+    };
+
+    struct InputStats {
+        SourceStats sources[static_cast<int>(Source::COUNT)];
+        int received;       // events offered to the stream
+        int coalesced;      // repeats of the current state, skipped
+        int dropped;        // overwritten because the game did not drain a player's queue
+        int reconnects;     // all channels
+        int channelCount;
+        ChannelStats channels[MAX_INPUT_CHANNELS];
+    };
+
+    // monotonic clock shared by every source, in microseconds
+    Uint64 NowUs();
+
+    void InitInput();
+    void ShutdownInput();
+
+    // drain pending SDL events into the stream; call once per frame from the render thread
+    void PumpInput();
+
+    // pop the oldest event of any player (menus); returns false when every queue is empty
+    bool PollInputEvent(InputEvent& event);
+    // pop the oldest event of one player (versus games)
+    bool PollPlayerEvent(int player, InputEvent& event);
+    // latest state of any player / of one player, for inputs that are held rather than pressed
+    Joystick CurrentJoystick();
+    Joystick PlayerJoystick(int player);
+    bool QuitRequested();
+
+    // thread-safe entry point for sources that run on their own thread
+    void PushInputEvent(const Joystick& state, Source source, int player, Uint64 sourceUs, Sint64 producerUs = -1, Sint64 bridgeUs = -1);
+
+    InputStats GetInputStats();
+    void PrintInputStats();
+}
+
+#endif
@@ -0,0 +1,387 @@
+#include "journal.h"
+#include "alloc_tracker.h"
+#include "input.h"
+#include "logger.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+    const uint32_t JOURNAL_MAGIC = 0x4a565342;  // "BSVJ"
+    const uint32_t JOURNAL_VERSION = 2;
+    const size_t MIN_SLOT_BYTES = 4096;
+    const uint32_t QUEUE_SIZE = 16;             // finished sessions waiting for the worker, power of two
+    const int IDLE_SLEEP_MS = 50;
+    const int GAMES = static_cast<int>(journal::Game::COUNT);
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t generation;    // bumped on every write, the newer valid slot wins
+        uint64_t sessions;      // records ever written; the next one goes to sessions % capacity
+        uint32_t capacity;
+        uint32_t recordSize;
+        uint32_t slotBytes;     // the layout depends on the page size of the machine that wrote it
+        journal::HighScore best[GAMES][journal::DIFFICULTIES][journal::HIGH_SCORES];
+        uint32_t crc;
+    };
+    static_assert(sizeof(Header) <= MIN_SLOT_BYTES, "header slot too small");
+
+    uint8_t* map = nullptr;
+    size_t map_bytes = 0;
+    size_t page_bytes = 4096;
+    // two header slots of a page each, so writing back one never rewrites the other's page or
+    // filesystem block and a torn write leaves the other intact; the records follow
+    size_t slot_bytes = MIN_SLOT_BYTES;
+    int fd = -1;
+    bool enabled = false;
+
+    // single producer (render thread), single consumer (journal worker)
+    journal::SessionRecord queue[QUEUE_SIZE];
+    std::atomic<uint32_t> head(0);
+    std::atomic<uint32_t> tail(0);
+    std::thread worker_thread;
+    std::atomic<bool> worker_running(false);
+
+    // worker thread once started; InitJournal before that
+    Header header = {};
+    std::atomic<uint32_t> written(0);
+    std::atomic<uint64_t> max_flush_us(0);
+
+    // render thread
+    journal::HighScore best[GAMES][journal::DIFFICULTIES][journal::HIGH_SCORES] = {};
+    journal::JournalStats stats = {};
+    bool in_session = false;
+    journal::SessionRecord current = {};
+    Uint64 session_start_us = 0;
+    input::InputStats input_start = {};
+
+    uint32_t crc_table[256];
+
+    void BuildCrcTable() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            crc_table[i] = c;
+        }
+    }
+
+    // CRC-32 (IEEE), as zlib computes it
+    uint32_t Crc32(const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        uint32_t c = 0xffffffffu;
+        for (size_t i = 0; i < size; i++) c = crc_table[(c ^ bytes[i]) & 0xff] ^ (c >> 8);
+        return c ^ 0xffffffffu;
+    }
+
+    uint32_t HeaderCrc(const Header& h) {
+        return Crc32(&h, offsetof(Header, crc));
+    }
+
+    uint32_t RecordCrc(const journal::SessionRecord& record) {
+        return Crc32(&record, offsetof(journal::SessionRecord, crc));
+    }
+
+    Header* Slot(int index) {
+        return reinterpret_cast<Header*>(map + index * slot_bytes);
+    }
+
+    journal::SessionRecord* RecordAt(uint64_t sequence) {
+        return reinterpret_cast<journal::SessionRecord*>(map + 2 * slot_bytes) + sequence % journal::CAPACITY;
+    }
+
+    bool ValidHeader(const Header& h) {
+        return h.magic == JOURNAL_MAGIC && h.version == JOURNAL_VERSION && h.capacity == journal::CAPACITY &&
+               h.recordSize == sizeof(journal::SessionRecord) && h.slotBytes == slot_bytes && h.crc == HeaderCrc(h);
+    }
+
+    // msync wants page-aligned ranges
+    void Sync(const void* at, size_t size) {
+        uintptr_t start = reinterpret_cast<uintptr_t>(at) & ~(page_bytes - 1);
+        uintptr_t end = reinterpret_cast<uintptr_t>(at) + size;
+        if (msync(reinterpret_cast<void*>(start), end - start, MS_SYNC) != 0) {
+            logger::Warn("Journal msync failed: %s", strerror(errno));
+        }
+    }
+
+    // descending; a tie keeps the older score ahead
+    void AddHighScore(journal::HighScore table[journal::HIGH_SCORES], int32_t score, uint32_t session) {
+        int at = 0;
+        while (at < journal::HIGH_SCORES && table[at].session != 0 && table[at].score >= score) at++;
+        if (at == journal::HIGH_SCORES) return;
+        memmove(table + at + 1, table + at, (journal::HIGH_SCORES - 1 - at) * sizeof(journal::HighScore));
+        table[at] = {score, session};
+    }
+
+    void AddToTable(journal::HighScore table[][journal::DIFFICULTIES][journal::HIGH_SCORES], const journal::SessionRecord& record) {
+        if (record.game >= GAMES || record.difficulty >= journal::DIFFICULTIES) return;
+        AddHighScore(table[record.game][record.difficulty], record.score, static_cast<uint32_t>(record.sequence + 1));
+    }
+
+    // the header goes to the slot not holding the newest one, so it is never overwritten in place
+    void WriteHeader() {
+        header.generation++;
+        header.crc = HeaderCrc(header);
+        Header* slot = Slot(header.generation % 2);
+        memcpy(slot, &header, sizeof(header));
+        Sync(slot, sizeof(header));
+    }
+
+    // record first, header second: power loss in between leaves a valid record past the
+    // header's count, which the next load recovers
+    void Append(journal::SessionRecord record) {
+        Uint64 start = input::NowUs();
+        record.sequence = header.sessions;
+        record.crc = RecordCrc(record);
+        journal::SessionRecord* slot = RecordAt(record.sequence);
+        memcpy(slot, &record, sizeof(record));
+        Sync(slot, sizeof(record));
+
+        header.sessions++;
+        AddToTable(header.best, record);
+        WriteHeader();
+
+        uint64_t cost = input::NowUs() - start;
+        if (cost > max_flush_us.load(std::memory_order_relaxed)) max_flush_us.store(cost, std::memory_order_relaxed);
+        written.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    int Drain() {
+        int count = 0;
+        uint32_t next = head.load(std::memory_order_relaxed);
+        uint32_t last = tail.load(std::memory_order_acquire);
+        for (; next != last; next++) {
+            Append(queue[next % QUEUE_SIZE]);
+            head.store(next + 1, std::memory_order_release);
+            count++;
+        }
+        return count;
+    }
+
+    void WorkerLoop() {
+        alloc_tracker::NameThread("journal");
+        while (worker_running.load()) {
+            if (Drain() == 0) std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_SLEEP_MS));
+        }
+        Drain();
+    }
+
+    bool ValidRecord(uint64_t sequence) {
+        const journal::SessionRecord& record = *RecordAt(sequence);
+        return record.sequence == sequence && record.crc == RecordCrc(record);
+    }
+
+    // no header survived (or the file is new): the session count and the high scores are
+    // rebuilt from the records in the ring, oldest first, so the ring is only read once per
+    // lost header rather than at every startup; scores from overwritten laps are gone
+    void Rebuild() {
+        uint64_t generation = std::max(Slot(0)->generation, Slot(1)->generation);
+        header = {};
+        header.magic = JOURNAL_MAGIC;
+        header.version = JOURNAL_VERSION;
+        header.generation = generation;
+        header.capacity = journal::CAPACITY;
+        header.recordSize = sizeof(journal::SessionRecord);
+        header.slotBytes = static_cast<uint32_t>(slot_bytes);
+
+        bool found = false;
+        uint64_t newest = 0;
+        for (uint32_t i = 0; i < journal::CAPACITY; i++) {
+            const journal::SessionRecord* record = reinterpret_cast<const journal::SessionRecord*>(map + 2 * slot_bytes) + i;
+            if (record->sequence % journal::CAPACITY != i || !ValidRecord(record->sequence)) continue;
+            if (!found || record->sequence > newest) newest = record->sequence;
+            found = true;
+        }
+        if (found) {
+            uint64_t oldest = newest + 1 > journal::CAPACITY ? newest + 1 - journal::CAPACITY : 0;
+            uint32_t count = 0;
+            for (uint64_t sequence = oldest; sequence <= newest; sequence++) {
+                if (!ValidRecord(sequence)) continue;
+                AddToTable(header.best, *RecordAt(sequence));
+                count++;
+            }
+            header.sessions = newest + 1;
+            logger::Warn("Journal: no valid header, rebuilt %u session(s) from the records", count);
+        }
+        WriteHeader();
+    }
+
+    // the newest valid header slot, then any records written after it; at most a queue's worth
+    // can be past the header, so this is constant time however long the journal is
+    uint32_t Load() {
+        const Header* a = Slot(0);
+        const Header* b = Slot(1);
+        bool validA = ValidHeader(*a), validB = ValidHeader(*b);
+        if (validA && (!validB || a->generation > b->generation)) header = *a;
+        else if (validB) header = *b;
+        else {
+            Rebuild();
+            return 0;
+        }
+
+        uint32_t recovered = 0;
+        for (; recovered < QUEUE_SIZE; recovered++) {
+            if (!ValidRecord(header.sessions)) break;
+            AddToTable(header.best, *RecordAt(header.sessions));
+            header.sessions++;
+        }
+        if (recovered > 0) WriteHeader();
+        return recovered;
+    }
+
+    uint32_t Average(Uint64 total, Uint64 count) {
+        return count ? static_cast<uint32_t>(total / count) : 0;
+    }
+}
+
+namespace journal {
+    bool InitJournal(const char* path) {
+        if (!path) return true;
+        BuildCrcTable();
+        page_bytes = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        slot_bytes = std::max(page_bytes, MIN_SLOT_BYTES);
+        map_bytes = 2 * slot_bytes + static_cast<size_t>(CAPACITY) * sizeof(SessionRecord);
+
+        fd = open(path, O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            logger::Error("Could not open journal %s: %s", path, strerror(errno));
+            return false;
+        }
+        // a new or short file is extended with zeros, which no checksum accepts; the blocks are
+        // allocated now, so a full disk cannot turn a later store into SIGBUS
+        struct stat info;
+        int error = fstat(fd, &info) != 0 ? errno : 0;
+        if (!error && static_cast<size_t>(info.st_size) < map_bytes) {
+            error = posix_fallocate(fd, 0, map_bytes);
+            if (!error && fsync(fd) != 0) error = errno;
+        }
+        if (error) {
+            logger::Error("Could not size journal %s: %s", path, strerror(error));
+            close(fd);
+            fd = -1;
+            return false;
+        }
+        void* mapped = mmap(nullptr, map_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            logger::Error("Could not map journal %s: %s", path, strerror(errno));
+            close(fd);
+            fd = -1;
+            return false;
+        }
+        map = static_cast<uint8_t*>(mapped);
+        enabled = true;
+
+        stats.recovered = Load();
+        memcpy(best, header.best, sizeof(best));
+        stats.sessions = header.sessions;
+        if (stats.recovered > 0) logger::Warn("Journal: recovered %u session(s) written before a lost header update", stats.recovered);
+        logger::Info("Journal %s: %u sessions", path, header.sessions);
+
+        worker_running = true;
+        worker_thread = std::thread(WorkerLoop);
+        return true;
+    }
+
+    void ShutdownJournal() {
+        if (!map) return;
+        if (worker_running.exchange(false) && worker_thread.joinable()) worker_thread.join();
+        munmap(map, map_bytes);
+        map = nullptr;
+        close(fd);
+        fd = -1;
+    }
+
+    void BeginSession(Game game, int difficulty) {
+        if (!map) return;
+        in_session = true;
+        current = {};
+        current.startUnix = static_cast<uint64_t>(time(nullptr));
+        current.game = static_cast<uint8_t>(game);
+        current.difficulty = static_cast<uint8_t>(difficulty);
+        current.players = game == Game::BLOCKER_VERSUS || game == Game::RUNNER_VERSUS ? 2 : 1;
+        session_start_us = input::NowUs();
+        input_start = input::GetInputStats();
+    }
+
+    void EndSession(int score, int winner) {
+        if (!map || !in_session) return;
+        in_session = false;
+        current.durationMs = static_cast<uint32_t>((input::NowUs() - session_start_us) / 1000);
+        current.score = score;
+        current.winner = static_cast<int8_t>(winner);
+
+        // input over the session is the difference of the running totals
+        input::InputStats end = input::GetInputStats();
+        current.inputEvents = end.received - input_start.received;
+        current.inputDropped = end.dropped - input_start.dropped;
+        Uint64 events = 0, latency = 0, timestamped = 0, bleLatency = 0;
+        for (int i = 0; i < static_cast<int>(input::Source::COUNT); i++) {
+            events += end.sources[i].events - input_start.sources[i].events;
+            latency += end.sources[i].totalLatencyUs - input_start.sources[i].totalLatencyUs;
+        }
+        for (int i = 0; i < end.channelCount; i++) {
+            timestamped += end.channels[i].timestamped - input_start.channels[i].timestamped;
+            bleLatency += end.channels[i].totalLatencyUs - input_start.channels[i].totalLatencyUs;
+        }
+        current.inputLatencyAvgUs = Average(latency, events);
+        current.bleLatencyAvgUs = Average(bleLatency, timestamped);
+
+        // a session that cannot be queued is never written, so it must not reach the table either
+        uint32_t next = tail.load(std::memory_order_relaxed);
+        if (next - head.load(std::memory_order_acquire) >= QUEUE_SIZE) {
+            stats.dropped++;
+            return;
+        }
+
+        // the render thread's own table answers BestScore, the worker keeps the file's
+        int previousBest = BestScore(static_cast<Game>(current.game), current.difficulty);
+        current.sequence = stats.sessions;
+        AddToTable(best, current);
+        if (score > previousBest && previousBest >= 0) logger::Info("New high score: %d (was %d)", score, previousBest);
+
+        queue[next % QUEUE_SIZE] = current;
+        tail.store(next + 1, std::memory_order_release);
+        stats.queued++;
+        stats.sessions++;
+    }
+
+    int BestScore(Game game, int difficulty) {
+        int index = static_cast<int>(game);
+        if (index < 0 || index >= GAMES || difficulty < 0 || difficulty >= DIFFICULTIES) return -1;
+        const HighScore& top = best[index][difficulty][0];
+        return top.session ? top.score : -1;
+    }
+
+    JournalStats GetJournalStats() {
+        JournalStats result = stats;
+        result.written = written.load(std::memory_order_relaxed);
+        result.maxFlushUs = max_flush_us.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    void PrintJournalStats() {
+        if (!enabled) return;
+        static const char* games[] = {"blocker", "runner", "blocker versus", "runner versus"};
+        static const char* difficulties[] = {"easy", "medium", "hard"};
+        JournalStats s = GetJournalStats();
+        logger::Info("Journal: %u sessions, %u queued this run, %u written, %u dropped, slowest flush %u us",
+                     s.sessions, s.queued, s.written, s.dropped, s.maxFlushUs);
+        for (int game = 0; game < GAMES; game++) {
+            for (int difficulty = 0; difficulty < DIFFICULTIES; difficulty++) {
+                const HighScore* table = best[game][difficulty];
+                if (table[0].session == 0) continue;
+                logger::Info("  %s %s: best %d, then %d, %d", games[game], difficulties[difficulty], table[0].score,
+                             table[1].session ? table[1].score : 0, table[2].session ? table[2].score : 0);
+            }
+        }
+    }
+}
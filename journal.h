@@ -0,0 +1,79 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stdint.h>
+
+// persistent session journal and high-score table (--journal FILE), built for a kiosk that can
+// lose power at any moment
+// the file is memory-mapped: two checksummed header slots of a page each, written alternately,
+// then a ring of fixed-size checksummed session records; a torn write only ever loses the slot
+// being written, and loading reads the newest valid header, so startup costs the same for any
+// number of sessions; if both headers are lost they are rebuilt from the records
+// the games only queue a finished session; a worker thread writes and msyncs it
+namespace journal {
+    const char* const DEFAULT_PATH = "boyvspear.journal";
+    const uint32_t CAPACITY = 8192;     // sessions kept, the oldest is overwritten after that
+    const int HIGH_SCORES = 5;          // per game and difficulty
+
+    // in main menu order
+    enum class Game : uint8_t {
+        BLOCKER,
+        RUNNER,
+        BLOCKER_VERSUS,
+        RUNNER_VERSUS,
+        COUNT
+    };
+    const int DIFFICULTIES = 3;         // easy, medium, hard in both games
+
+    struct SessionRecord {
+        uint64_t sequence;          // sessions written before this one; tells a new record from an old lap
+        uint64_t startUnix;         // wall clock seconds
+        uint32_t durationMs;
+        int32_t score;              // spears blocked / seconds survived; versus: the winner's
+        uint8_t game;               // Game
+        uint8_t difficulty;
+        uint8_t players;
+        int8_t winner;              // versus: winning player, -1 for a draw; -1 when solo
+        // input over the session
+        uint32_t inputEvents;
+        uint32_t inputDropped;
+        uint32_t inputLatencyAvgUs; // device timestamp -> dequeued by the game
+        uint32_t bleLatencyAvgUs;   // ESP32 -> game, 0 without timestamped BLE input
+        uint32_t reserved[3];
+        uint32_t crc;               // CRC-32 of everything above
+    };
+    static_assert(sizeof(SessionRecord) == 64, "journal records are fixed-size");
+
+    struct HighScore {
+        int32_t score;
+        uint32_t session;           // sequence + 1 of the session that set it, 0 for an empty entry
+    };
+
+    struct JournalStats {
+        uint64_t sessions;          // in the file, including earlier runs
+        uint32_t queued;
+        uint32_t written;
+        uint32_t dropped;           // queue full, the worker was behind
+        uint32_t recovered;         // records found past a header lost to power loss
+        uint64_t maxFlushUs;        // slowest record + header msync
+    };
+
+    // maps the file (creating it if needed) and starts the worker; does nothing without a path
+    // call before realtime::InitRealtime so the worker does not inherit the render thread's core
+    bool InitJournal(const char* path);
+    // writes whatever is still queued, then unmaps the file
+    void ShutdownJournal();
+
+    // render thread, when a game enters and leaves PLAYING; never blocks and never allocates
+    void BeginSession(Game game, int difficulty);
+    // winner as in SessionRecord; sessions left by quitting are not recorded
+    void EndSession(int score, int winner);
+
+    // best score so far, -1 when there is none
+    int BestScore(Game game, int difficulty);
+
+    JournalStats GetJournalStats();
+    void PrintJournalStats();
+}
+
+#endif
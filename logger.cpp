@@ -0,0 +1,252 @@
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace logger {
+    namespace detail {
+        std::atomic<int> current_level(static_cast<int>(Level::INFO));
+    }
+}
+
+namespace {
+    using logger::detail::Arg;
+    using logger::detail::Record;
+
+    const uint32_t RING_CAPACITY = 256;     // records per thread, power of two
+    const int IDLE_SLEEP_MS = 5;
+
+    // single producer (the owning thread), single consumer (the writer thread)
+    struct Ring {
+        Record records[RING_CAPACITY];
+        std::atomic<uint32_t> head{0};      // next record to write out
+        std::atomic<uint32_t> tail{0};      // next free slot
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    const int MAX_RINGS = 32;               // threads that can log; later ones have their records dropped
+
+    std::mutex registry_mutex;              // only taken when a thread logs for the first time
+    // static so a thread's first record never touches the heap; untouched rings cost no memory
+    Ring rings[MAX_RINGS];
+    std::atomic<int> ring_count(0);
+    std::atomic<uint64_t> unregistered_dropped(0);
+    thread_local Ring* thread_ring = nullptr;
+
+    std::once_flag start_flag;
+    std::thread writer_thread;
+    std::atomic<bool> writer_running(false);
+    std::atomic<uint64_t> written(0);
+    uint64_t start_us = 0;
+
+    uint64_t NowUs() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // print one argument for a printf conversion, converting the stored value as needed
+    int FormatArg(char* out, size_t size, const char* spec, size_t specLen, char conversion, const Record& record, const Arg& arg) {
+        // rebuild the spec (flags, width, precision) with the modifier the stored type needs
+        char format[32];
+        if (specLen > sizeof(format) - 4) specLen = sizeof(format) - 4;
+        memcpy(format, spec, specLen);
+        char* end = format + specLen;
+
+        switch (conversion) {
+            case 'd': case 'i': {
+                int64_t value = arg.type == Arg::DOUBLE ? static_cast<int64_t>(arg.d) : arg.i;
+                strcpy(end, "lld");
+                return snprintf(out, size, format, static_cast<long long>(value));
+            }
+            case 'u': case 'x': case 'X': case 'c': {
+                uint64_t value = arg.type == Arg::DOUBLE ? static_cast<uint64_t>(arg.d) : arg.u;
+                if (conversion == 'c') { end[0] = 'c'; end[1] = '\0'; return snprintf(out, size, format, static_cast<int>(value)); }
+                end[0] = 'l'; end[1] = 'l'; end[2] = conversion; end[3] = '\0';
+                return snprintf(out, size, format, static_cast<unsigned long long>(value));
+            }
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': {
+                double value = arg.type == Arg::DOUBLE ? arg.d : (arg.type == Arg::INT ? static_cast<double>(arg.i) : static_cast<double>(arg.u));
+                end[0] = conversion; end[1] = '\0';
+                return snprintf(out, size, format, value);
+            }
+            default: {
+                if (arg.type == Arg::STRING) {
+                    end[0] = 's'; end[1] = '\0';
+                    return snprintf(out, size, format, record.text + arg.text);
+                }
+                if (arg.type == Arg::DOUBLE) return snprintf(out, size, "%g", arg.d);
+                if (arg.type == Arg::INT) return snprintf(out, size, "%lld", static_cast<long long>(arg.i));
+                return snprintf(out, size, "%llu", static_cast<unsigned long long>(arg.u));
+            }
+        }
+    }
+
+    size_t FormatRecord(const Record& record, char* out, size_t size) {
+        static const char* tags[] = {"DEBUG ", "", "WARN ", "ERROR "};
+        int used = snprintf(out, size, "[%8.3f] %s", (record.timeUs - start_us) / 1e6, tags[static_cast<int>(record.level)]);
+        size_t pos = used > 0 ? static_cast<size_t>(used) : 0;
+        int argIndex = 0;
+
+        for (const char* c = record.format; *c && pos + 1 < size; c++) {
+            if (*c != '%') { out[pos++] = *c; continue; }
+            if (c[1] == '%') { out[pos++] = '%'; c++; continue; }
+
+            // %[flags][width][.precision][length]conversion
+            const char* spec = c++;
+            while (*c && strchr("-+ #0123456789.", *c)) c++;
+            size_t specLen = c - spec;
+            while (*c && strchr("hlzjtL", *c)) c++;
+            if (!*c) break;
+            if (argIndex >= record.argCount) continue;  // missing argument, print nothing
+
+            int n = FormatArg(out + pos, size - pos, spec, specLen, *c, record, record.args[argIndex++]);
+            if (n > 0) pos = std::min(size - 1, pos + static_cast<size_t>(n));
+        }
+        out[pos++] = '\n';
+        return pos;
+    }
+
+    // drain every ring; returns the number of records written
+    int Drain() {
+        char line[512];
+        int count = 0;
+        bool wroteOut = false, wroteErr = false;
+        int count_rings = ring_count.load(std::memory_order_acquire);
+        for (int i = 0; i < count_rings; i++) {
+            Ring* ring = &rings[i];
+            uint32_t head = ring->head.load(std::memory_order_relaxed);
+            uint32_t tail = ring->tail.load(std::memory_order_acquire);
+            for (; head != tail; head++) {
+                const Record& record = ring->records[head % RING_CAPACITY];
+                size_t length = FormatRecord(record, line, sizeof(line) - 1);
+                bool error = record.level >= logger::Level::WARN;
+                fwrite(line, 1, length, error ? stderr : stdout);
+                (error ? wroteErr : wroteOut) = true;
+                count++;
+            }
+            ring->head.store(head, std::memory_order_release);
+        }
+        if (wroteOut) fflush(stdout);
+        if (wroteErr) fflush(stderr);
+        written += count;
+        return count;
+    }
+
+    void WriterLoop() {
+        while (writer_running.load()) {
+            if (Drain() == 0) std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_SLEEP_MS));
+        }
+        Drain();
+    }
+
+    // SIGUSR1 makes the log more verbose, SIGUSR2 quieter, without restarting the cabinet
+    void HandleLevelSignal(int signal) {
+        int level = logger::detail::current_level.load();
+        if (signal == SIGUSR1 && level > static_cast<int>(logger::Level::DEBUG)) level--;
+        if (signal == SIGUSR2 && level < static_cast<int>(logger::Level::OFF)) level++;
+        logger::detail::current_level.store(level);
+    }
+
+    void StartWriter() {
+        start_us = NowUs();
+        writer_running = true;
+        writer_thread = std::thread(WriterLoop);
+        signal(SIGUSR1, HandleLevelSignal);
+        signal(SIGUSR2, HandleLevelSignal);
+        atexit(logger::StopLogger);
+    }
+
+    Ring* ThreadRing() {
+        if (!thread_ring) {
+            std::call_once(start_flag, StartWriter);
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            int count = ring_count.load(std::memory_order_relaxed);
+            if (count == MAX_RINGS) return nullptr;
+            // rings live until exit so the writer never races a dying thread
+            thread_ring = &rings[count];
+            ring_count.store(count + 1, std::memory_order_release);
+        }
+        return thread_ring;
+    }
+}
+
+namespace logger {
+    void SetLevel(Level level) {
+        detail::current_level.store(static_cast<int>(level));
+    }
+
+    Level GetLevel() {
+        return static_cast<Level>(detail::current_level.load());
+    }
+
+    bool ParseLevel(const char* name, Level& level) {
+        static const char* names[] = {"debug", "info", "warn", "error", "off"};
+        for (int i = 0; i <= static_cast<int>(Level::OFF); i++) {
+            if (!strcmp(name, names[i])) {
+                level = static_cast<Level>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    LogStats GetLogStats() {
+        LogStats stats = {written.load(), unregistered_dropped.load()};
+        int count = ring_count.load(std::memory_order_acquire);
+        for (int i = 0; i < count; i++) stats.dropped += rings[i].dropped.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    void StartLogger() {
+        ThreadRing();
+    }
+
+    void StopLogger() {
+        if (writer_running.exchange(false) && writer_thread.joinable()) writer_thread.join();
+    }
+
+    namespace detail {
+        Record* BeginRecord(Level level, const char* format) {
+            Ring* ring = ThreadRing();
+            if (!ring) {
+                unregistered_dropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+            if (tail - ring->head.load(std::memory_order_acquire) >= RING_CAPACITY || !writer_running.load(std::memory_order_relaxed)) {
+                ring->dropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            Record* record = &ring->records[tail % RING_CAPACITY];
+            record->timeUs = NowUs();
+            record->format = format;
+            record->level = level;
+            record->argCount = 0;
+            record->textUsed = 0;
+            return record;
+        }
+
+        void CommitRecord(Record* record) {
+            Ring* ring = thread_ring;
+            ring->tail.store(ring->tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        void StoreString(Record& record, const char* value) {
+            Arg& arg = record.args[record.argCount++];
+            arg.type = Arg::STRING;
+            arg.text = record.textUsed;
+            if (!value) value = "(null)";
+            size_t room = TEXT_BYTES - record.textUsed - 1;
+            size_t length = strnlen(value, room);
+            memcpy(record.text + record.textUsed, value, length);
+            record.text[record.textUsed + length] = '\0';
+            record.textUsed += static_cast<uint8_t>(length + 1);
+            if (record.textUsed >= TEXT_BYTES) record.textUsed = TEXT_BYTES - 1;
+        }
+    }
+}
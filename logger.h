@@ -0,0 +1,117 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <type_traits>
+
+// asynchronous logger: game threads copy fixed-size binary records into their own lock-free
+// ring and a background thread formats and writes them, so a slow terminal never stalls a frame
+// format strings use printf conversions (%d %u %f %s ...); length modifiers are not needed
+namespace logger {
+    enum class Level {
+        DEBUG,
+        INFO,
+        WARN,
+        ERROR,
+        OFF
+    };
+
+    struct LogStats {
+        uint64_t written;
+        uint64_t dropped;   // records lost because a thread's ring was full
+    };
+
+    void SetLevel(Level level);
+    Level GetLevel();
+    bool ParseLevel(const char* name, Level& level);
+    LogStats GetLogStats();
+
+    // starts lazily on the first record; StartLogger() starts the writer and registers the calling
+    // thread up front, so no frame pays for it. StopLogger() drains everything still queued
+    void StartLogger();
+    void StopLogger();
+
+    namespace detail {
+        const int MAX_ARGS = 6;
+        const int TEXT_BYTES = 96;  // copies of string arguments, truncated to fit
+
+        struct Arg {
+            enum Type : uint8_t { INT, UINT, DOUBLE, STRING } type;
+            union {
+                int64_t i;
+                uint64_t u;
+                double d;
+                uint32_t text;  // offset into Record::text
+            };
+        };
+
+        struct Record {
+            uint64_t timeUs;
+            const char* format;     // must be a string literal, it is read later by the writer
+            Level level;
+            uint8_t argCount;
+            uint8_t textUsed;
+            Arg args[MAX_ARGS];
+            char text[TEXT_BYTES];
+        };
+
+        extern std::atomic<int> current_level;
+
+        // nullptr if the calling thread's ring is full (the drop is counted)
+        Record* BeginRecord(Level level, const char* format);
+        void CommitRecord(Record* record);
+        void StoreString(Record& record, const char* value);
+
+        inline void Store(Record&) {}
+
+        template <typename T, typename... Rest>
+        void Store(Record& record, const T& value, const Rest&... rest) {
+            if (record.argCount < MAX_ARGS) {
+                if constexpr (std::is_convertible<const T&, const char*>::value) {
+                    StoreString(record, value);
+                }
+                else if constexpr (std::is_same<T, std::string>::value) {
+                    StoreString(record, value.c_str());
+                }
+                else {
+                    Arg& arg = record.args[record.argCount++];
+                    if constexpr (std::is_floating_point<T>::value) {
+                        arg.type = Arg::DOUBLE;
+                        arg.d = value;
+                    }
+                    else if constexpr (std::is_enum<T>::value || (std::is_integral<T>::value && std::is_signed<T>::value)) {
+                        arg.type = Arg::INT;
+                        arg.i = static_cast<int64_t>(value);
+                    }
+                    else if constexpr (std::is_integral<T>::value) {
+                        arg.type = Arg::UINT;
+                        arg.u = static_cast<uint64_t>(value);
+                    }
+                    else {
+                        arg.type = Arg::UINT;
+                        arg.u = reinterpret_cast<uintptr_t>(value);
+                    }
+                }
+            }
+            Store(record, rest...);
+        }
+    }
+
+    template <typename... Args>
+    void Log(Level level, const char* format, const Args&... args) {
+        if (static_cast<int>(level) < detail::current_level.load(std::memory_order_relaxed)) return;
+        detail::Record* record = detail::BeginRecord(level, format);
+        if (!record) return;
+        detail::Store(*record, args...);
+        detail::CommitRecord(record);
+    }
+
+    template <typename... Args> void Debug(const char* format, const Args&... args) { Log(Level::DEBUG, format, args...); }
+    template <typename... Args> void Info(const char* format, const Args&... args) { Log(Level::INFO, format, args...); }
+    template <typename... Args> void Warn(const char* format, const Args&... args) { Log(Level::WARN, format, args...); }
+    template <typename... Args> void Error(const char* format, const Args&... args) { Log(Level::ERROR, format, args...); }
+}
+
+#endif
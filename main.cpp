@@ -1,70 +1,84 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
-#include <iostream>
+#include "alloc_tracker.h"
+#include "capture.h"
+#include "governor.h"
 #include "assets.h"
+#include "input.h"
+#include "journal.h"
+#include "logger.h"
+#include "options.h"
+#include "particles.h"
+#include "realtime.h"
+#include "render_scale.h"
+#include "resources.h"
+#include "sim.h"
+#include "softraster.h"
+#include "telemetry.h"
 #include "spear_blocker.h"
 #include "spear_runner.h"
 
 int main(int argc, char* argv[]) {
+    if (!ParseOptions(argc, argv)) return 1;
+    logger::StartLogger();
+    alloc_tracker::NameThread("render");
+    if (options.headless) {
+        // no display needed; the renderer falls back to software on the dummy driver
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+        SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+    }
+
     if (SDL_Init(SDL_INIT_VIDEO) < 0 || TTF_Init() == -1) {
-        std::cout << "Failed to initialize SDL/TTF: " << SDL_GetError() << "\n";
+        logger::Error("Failed to initialize SDL/TTF: %s", SDL_GetError());
         return 1;
     }
 
-    SDL_Window* window = SDL_CreateWindow("Game Selector", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
-    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
-    TTF_Font* font = TTF_OpenFont(FONT_PATH, 28);
+    // parse the font and rasterize its glyphs while the window and renderer come up
+    resources::PreloadFontAsync(FONT_PATH, 28);
+
+    Uint32 windowFlags = options.headless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN;
+    Uint32 rendererFlags = options.headless ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC;
+    SDL_Window* window = SDL_CreateWindow("Game Selector", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, SCREEN_WIDTH, SCREEN_HEIGHT, windowFlags);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, rendererFlags);
+    TTF_Font* font = resources::AcquireFont(FONT_PATH, 28);    // shared with both games
 
     if (!window || !renderer || !font) {
-        std::cout << "Error creating window, renderer, or font." << "\n";
+        logger::Error("Error creating window, renderer, or font.");
         return 1;
     }
 
+    // presents wait for vsync, so neither the loops nor the simulation can outrun the display
+    SDL_DisplayMode mode;
+    if (!options.headless && SDL_GetWindowDisplayMode(window, &mode) == 0 && mode.refresh_rate > 0) {
+        SetDisplayRefresh(mode.refresh_rate);
+        sim::LimitToDisplay(mode.refresh_rate);
+    }
+
     bool running = true;
+    const int GAME_COUNT = 4;   // both games, then their two-player versions
     int selectedGame = 0;
 
-    // joystick thread
-    std::thread joystick_thread;
+    if (options.softwareRaster) softraster::InitSoftRaster(renderer);
+    render_scale::InitRenderScale(renderer);
+    // everything the governor may switch to mid-game is created now
+    LoadPlayerSprites(renderer);
+    InitHud(renderer);
+    // the encoder and journal threads must start before the render thread is pinned, or they would share its core
+    if (!capture::InitCapture(renderer)) return 1;
+    // a journal that cannot be opened only costs the high scores, the games still run
+    journal::InitJournal(options.journalPath);
+    // after startup work, so only the game threads run pinned / SCHED_FIFO
+    realtime::InitRealtime();
+    // keyboard, game controllers and the BLE FIFOs (read on their own thread)
+    input::InitInput();
+    // watch with: ./game_stats
+    telemetry::InitTelemetry(options.statsSocket);
 
     while (running) {
         printFPS();
-
-        // check if stream is open, if not, try to open it
-        if (!fifo_stream.is_open()) {
-            // check if the FIFO file exists and is a FIFO before opening
-            struct stat stat_buf;
-            if (stat(FIFO_PATH, &stat_buf) == 0) {
-                if (!S_ISFIFO(stat_buf.st_mode)) {
-                    std::cerr << "Error: " << FIFO_PATH << " exists but is not a FIFO." << "\n";
-                    // wait before retrying
-                    sleep(5); 
-                    continue;
-                }
-            }
-            else {
-                // file doesn't exist yet, wait for Python script to create it
-                if (errno == ENOENT) std::cout << "FIFO not found, waiting..." << "\n";
-                // other stat error
-                else perror("Error checking FIFO status");
-                sleep(2);
-                continue;
-            }
-
-            // open the FIFO for reading
-            // blocks until the Python script opens FIFO for writing
-            std::cout << "Attempting to open FIFO: " << FIFO_PATH << "\n";
-            fifo_stream.open(FIFO_PATH);
-
-            if (!fifo_stream.is_open()) {
-                std::cerr << "Error opening FIFO: " << FIFO_PATH << ". Retrying..." << "\n";
-                sleep(2); // wait before retrying
-                continue;
-            } else {
-                std::cout << "FIFO opened successfully." << "\n";
-                // launch the joystick reading thread
-                joystick_thread = std::thread(read_joystick);
-            }
-        }
+        input::PumpInput();
+        if (input::QuitRequested()) break;
+        telemetry::SetSpearCount(0);
 
         // render menu
         SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
@@ -74,34 +88,24 @@ int main(int argc, char* argv[]) {
         SDL_Color yellow = {255, 255, 0, 255};
 
         // simple menu display
-        SDL_Surface* surface = TTF_RenderText_Blended(font, "Spear Blocker", selectedGame == 0 ? yellow : white);
-        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-        SDL_Rect rect = {SCREEN_WIDTH / 2 - surface->w / 2, SCREEN_HEIGHT / 2 - 50, surface->w, surface->h};
-        SDL_RenderCopy(renderer, texture, NULL, &rect);
-        SDL_FreeSurface(surface);
-        SDL_DestroyTexture(texture);
-        surface = TTF_RenderText_Blended(font, "Spear Runner", selectedGame == 1 ? yellow : white);
-        texture = SDL_CreateTextureFromSurface(renderer, surface);
-        rect = {SCREEN_WIDTH / 2 - surface->w / 2, SCREEN_HEIGHT / 2 + 10, surface->w, surface->h};
-        SDL_RenderCopy(renderer, texture, NULL, &rect);
-        SDL_FreeSurface(surface);
-        SDL_DestroyTexture(texture);
-        SDL_RenderPresent(renderer);
-        SDL_Delay(16);
-
-        bool descend_menu = false, ascend_menu = false, enter_game = false;
-        {   // scope the mutex
-            std::lock_guard<std::mutex> lock(joy_mutex);
-            if (joy_action) {
-                joy_action = false;
-                if (joy.y == UP) ascend_menu = true;
-                else if (joy.y == DOWN) descend_menu = true;
-                else if (joy.btn == PRESSED) enter_game = true;
-            }
-        }   // automatically frees here
-        if (ascend_menu) selectedGame = (selectedGame-1+2)%2;
-        else if (descend_menu) selectedGame = (selectedGame+1)%2;
-        else if (enter_game) {
+        int lineOffset = TTF_FontHeight(font) / 2;
+        RenderText(renderer, font, "Spear Blocker", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 - 110 + lineOffset, selectedGame == 0 ? yellow : white);
+        RenderText(renderer, font, "Spear Runner", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 - 50 + lineOffset, selectedGame == 1 ? yellow : white);
+        RenderText(renderer, font, "Blocker Versus", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 + 10 + lineOffset, selectedGame == 2 ? yellow : white);
+        RenderText(renderer, font, "Runner Versus", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 + 70 + lineOffset, selectedGame == 3 ? yellow : white);
+        capture::PresentFrame(renderer);
+        FrameDelay(16);
+
+        bool enter_game = false;
+        input::InputEvent event;
+        while (!enter_game && input::PollInputEvent(event)) {
+            const Joystick& joy = event.state;
+            if (joy.y == UP) selectedGame = (selectedGame-1+GAME_COUNT)%GAME_COUNT;
+            else if (joy.y == DOWN) selectedGame = (selectedGame+1)%GAME_COUNT;
+            else if (joy.btn == PRESSED) enter_game = true;
+        }
+        if (enter_game) {
+            particles::ClearParticles();
             if (selectedGame==0) {
                 if (SpearBlockerMain(window, renderer) == -1) {
                     running = false;
@@ -112,16 +116,46 @@ int main(int argc, char* argv[]) {
                     running = false;
                 }
             }
+            else if (selectedGame==2) {
+                if (SpearBlockerVersusMain(window, renderer) == -1) {
+                    running = false;
+                }
+            }
+            else if (selectedGame==3) {
+                if (SpearRunnerVersusMain(window, renderer) == -1) {
+                    running = false;
+                }
+            }
         }
     }
 
-    TTF_CloseFont(font);
+    telemetry::ShutdownTelemetry();
+    capture::ShutdownCapture();
+    journal::ShutdownJournal();
+    input::ShutdownInput();
+    input::PrintInputStats();
+    PrintFrameStats();
+    realtime::PrintRealtimeStats();
+    capture::PrintCaptureStats();
+    render_scale::PrintScaleStats();
+    governor::PrintGovernorStats();
+    particles::PrintParticleStats();
+    journal::PrintJournalStats();
+    render_scale::ShutdownRenderScale();
+    softraster::ShutdownSoftRaster();
+    ShutdownHud();
+    ReleasePlayerSprites(renderer);
+    resources::ReleaseFont(font);
+    resources::PrintResourceStats();
+    resources::ShutdownResources();
+    alloc_tracker::PrintAllocStats();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     TTF_Quit();
     SDL_Quit();
+    // with --assert-zero-alloc a steady-state frame that touched the heap fails the run
+    bool allocFailed = options.assertZeroAlloc && alloc_tracker::GetFrameStats().steadyAllocFrames > 0;
+    logger::StopLogger();
 
-    if (joystick_thread.joinable()) joystick_thread.join();
-
-    return 0;
+    return allocFailed ? 2 : 0;
 }
@@ -1,15 +1,19 @@
 #include "menu.h"
+#include "alloc_tracker.h"
+#include "governor.h"
+#include "logger.h"
+#include "input.h"
+#include "options.h"
+#include "realtime.h"
+#include "render_scale.h"
+#include "resources.h"
+#include "telemetry.h"
+#include <algorithm>
 
 const int SCREEN_WIDTH = 500;
 const int SCREEN_HEIGHT = 500;
 const char* FONT_PATH = "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf";
 const char* FIFO_PATH = "/tmp/joystick_fifo";
-std::ifstream fifo_stream;
-std::string line;
-Joystick joy, old_joy = {-1,-1,-1};
-bool joy_action = false;    // flag for others accessing to use the input
-                            // otherwise don't update using joy to prevent "infinite" loop
-std::mutex joy_mutex;
 // variables for FPS calculation
 Uint64 lastTick = SDL_GetPerformanceCounter();
 Uint64 currentTick;
@@ -17,6 +21,13 @@ double deltaTime = 0;
 int frameCount = 0;
 double fpsTimer = 0;
 int fps = 0;
+// totals over the whole run, for comparing builds on the same replay
+long totalFrames = 0;
+double totalFrameTime = 0;
+double worstFrameTime = 0;
+// present interval, see FrameBudgetSeconds
+static Uint64 framePeriodUs = 1000000 / 60;
+static Uint64 refreshPeriodUs = 0;
 
 void printFPS() {
     // calculate delta time
@@ -24,13 +35,25 @@ void printFPS() {
     deltaTime = (double)(currentTick - lastTick) / SDL_GetPerformanceFrequency();
     lastTick = currentTick;
 
+    totalFrames++;
+    if (totalFrames > 1) {  // the first delta includes startup
+        totalFrameTime += deltaTime;
+        if (deltaTime > worstFrameTime) worstFrameTime = deltaTime;
+    }
+
+    telemetry::RecordFrame(deltaTime);
+    alloc_tracker::EndFrame();
+    // the first delta includes startup, which would read as one very slow frame
+    if (totalFrames > 1) render_scale::UpdateAutoScale(deltaTime);
+    governor::UpdateGovernor(deltaTime);
+
     // FPS calculation
     frameCount++;
     fpsTimer += deltaTime;
 
     if (fpsTimer >= 1.0) {
         fps = round((double)frameCount / fpsTimer);
-        std::cout << "FPS: " << fps << "\n";
+        logger::Info("FPS: %d", fps);
 
         // reset timers and frame count
         fpsTimer = 0;
@@ -38,54 +61,124 @@ void printFPS() {
     }
 }
 
-// read line by line from the FIFO stream
-void read_joystick() {
-    while (true) {
-        if (std::getline(fifo_stream, line)) {
-            // process the received line (X Y Button)
-            // std::cout << "Received: " << line << std::endl;
-
-            std::stringstream ss(line);
-            Joystick new_joy;
-            if (ss >> new_joy.x >> new_joy.y >> new_joy.btn) {
-                std::lock_guard<std::mutex> lock(joy_mutex);
-                // std::cout << "Parsed -> X: " << new_joy.x << ", Y: " << new_joy.y << ", Btn: " << new_joy.btn <<"\n";
-                if (new_joy != old_joy) joy_action = true;
-                joy = new_joy;
-                old_joy = new_joy;
-            } else {
-                std::cerr << "Warning: Could not parse line: " << line << "\n";
-            }
-
-        } else {
-            std::cout<<"getline failed\n"<<"\n";
-            // getline failed; this could mean the writer closed the pipe (EOF)
-            // or some other error occurred
-            if (fifo_stream.eof()) {
-                std::cout << "Writer closed the FIFO (EOF reached). Re-opening..." << std::endl;
-            } else if (fifo_stream.fail()) {
-                std::cerr << "Stream error occurred. Re-opening..." << std::endl;
-            } else {
-                    std::cerr << "Unknown stream state. Re-opening..." << std::endl;
-            }
-            fifo_stream.close();    // close the stream
-            fifo_stream.clear();    // clear error flags
-            sleep(1);               // small delay before trying to reopen
-            continue;
+void PrintFrameStats() {
+    if (totalFrames < 2) return;
+    logger::Info("Frames: %d, avg %.3f ms, worst %.3f ms", totalFrames, totalFrameTime * 1000.0 / (totalFrames - 1), worstFrameTime * 1000.0);
+}
+
+void FrameDelay(Uint32 ms) {
+    FrameDelayUs(static_cast<Uint64>(ms) * 1000);
+}
+
+void FrameDelayUs(Uint64 periodUs) {
+    framePeriodUs = periodUs;
+    // headless runs (replays, PGO training) go as fast as the CPU allows
+    if (options.headless) return;
+    // sleep to an absolute deadline one period after the last one, so time spent rendering
+    // is not added on top and the wake-up lateness can be measured against the target
+    static Uint64 nextWakeUs = 0;
+    Uint64 now = input::NowUs();
+    nextWakeUs += periodUs;
+    if (nextWakeUs + periodUs < now || nextWakeUs > now + periodUs) nextWakeUs = now + periodUs;  // fell behind, or first frame
+    realtime::SleepUntil(nextWakeUs);
+}
+
+void SetDisplayRefresh(int hz) {
+    refreshPeriodUs = hz > 0 ? 1000000 / hz : 0;
+}
+
+double FrameBudgetSeconds() {
+    return std::max(framePeriodUs, refreshPeriodUs) / 1e6;
+}
+
+// total pen advance of text drawn from a glyph atlas
+static int MeasureGlyphs(const resources::GlyphAtlas* atlas, const char* text) {
+    int width = 0;
+    for (const char* c = text; *c; c++) {
+        int index = static_cast<unsigned char>(*c) - resources::FIRST_GLYPH;
+        if (index >= 0 && index < resources::NUM_GLYPHS) width += atlas->advance[index];
+    }
+    return width;
+}
+
+// draw text from a glyph atlas with its top-left corner at (x, y)
+static void DrawGlyphs(SDL_Renderer* renderer, const resources::GlyphAtlas* atlas, const char* text, int x, int y, SDL_Color color) {
+    SDL_SetTextureColorMod(atlas->texture, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(atlas->texture, color.a);
+    for (const char* c = text; *c; c++) {
+        int index = static_cast<unsigned char>(*c) - resources::FIRST_GLYPH;
+        if (index < 0 || index >= resources::NUM_GLYPHS) continue;
+        const SDL_Rect& src = atlas->glyphs[index];
+        if (src.w > 0) {
+            SDL_Rect dst = {x, y, src.w, src.h};
+            SDL_RenderCopy(renderer, atlas->texture, &src, &dst);
+            telemetry::CountDrawCalls(1);
         }
+        x += atlas->advance[index];
+    }
+}
+
+// a score line drawn once into a texture and copied while the governor throttles the HUD
+struct HudLine {
+    SDL_Texture* texture;
+    int width;
+    long drawnFrame;
+    long usedFrame;     // a line skipped for a frame (menu, other game) is redrawn on return
+    bool valid;
+};
+
+static const int HUD_LINES = 2;
+static const int HUD_LINE_HEIGHT = 64;      // taller than the font's line height
+static const long HUD_REFRESH_FRAMES = 15;  // a throttled line is redrawn four times a second
+static HudLine hud_lines[HUD_LINES] = {};
+
+void InitHud(SDL_Renderer* renderer) {
+    if (!SDL_RenderTargetSupported(renderer)) return;
+    for (HudLine& line : hud_lines) {
+        line.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, SCREEN_WIDTH / 2, HUD_LINE_HEIGHT);
+        if (line.texture) SDL_SetTextureBlendMode(line.texture, SDL_BLENDMODE_BLEND);
+    }
+}
+
+void ShutdownHud() {
+    for (HudLine& line : hud_lines) {
+        if (line.texture) SDL_DestroyTexture(line.texture);
+        line = {};
+    }
+}
+
+// draw one HUD line at (x, 10), right-aligned to x when alignRight; throttled lines show the
+// text they had when last redrawn
+static void DrawHudLine(SDL_Renderer* renderer, const resources::GlyphAtlas* atlas, HudLine& line, const char* text, int x, bool alignRight, SDL_Color color) {
+    if (!governor::AtLeast(governor::Level::THROTTLED_HUD) || !line.texture) {
+        line.valid = false;
+        DrawGlyphs(renderer, atlas, text, alignRight ? x - MeasureGlyphs(atlas, text) : x, 10, color);
+        return;
+    }
+    if (!line.valid || totalFrames - line.drawnFrame >= HUD_REFRESH_FRAMES || totalFrames - line.usedFrame > 1) {
+        SDL_Texture* previous = SDL_GetRenderTarget(renderer);
+        SDL_SetRenderTarget(renderer, line.texture);
+        // transparent in the text colour, so blended glyph edges keep their colour
+        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 0);
+        SDL_RenderClear(renderer);
+        DrawGlyphs(renderer, atlas, text, 0, 0, color);
+        SDL_SetRenderTarget(renderer, previous);
+        line.width = MeasureGlyphs(atlas, text);
+        line.drawnFrame = totalFrames;
+        line.valid = true;
     }
+    line.usedFrame = totalFrames;
+    SDL_Rect source = {0, 0, line.width, atlas->height};
+    SDL_Rect dest = {alignRight ? x - line.width : x, 10, line.width, atlas->height};
+    SDL_RenderCopy(renderer, line.texture, &source, &dest);
+    telemetry::CountDrawCalls(1);
 }
 
-void RenderText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color) {
-    if (!font) return;
-    SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), color);
-    if (!surface) return;
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (!texture) { SDL_FreeSurface(surface); return; }
-    SDL_Rect destRect = { x - surface->w / 2, y - surface->h / 2, surface->w, surface->h };
-    SDL_RenderCopy(renderer, texture, NULL, &destRect);
-    SDL_DestroyTexture(texture);
-    SDL_FreeSurface(surface);
+void RenderText(SDL_Renderer* renderer, TTF_Font* font, const char* text, int x, int y, SDL_Color color) {
+    const resources::GlyphAtlas* atlas = resources::GetGlyphAtlas(renderer, font);
+    if (!atlas) return;
+    int width = MeasureGlyphs(atlas, text);
+    DrawGlyphs(renderer, atlas, text, x - width / 2, y - atlas->height / 2, color);
 }
 
 void RenderMenu(SDL_Renderer* renderer, TTF_Font* font, int selectedOption) {
@@ -98,31 +191,49 @@ void RenderMenu(SDL_Renderer* renderer, TTF_Font* font, int selectedOption) {
     RenderText(renderer, font, "Back",   SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 + 90, (selectedOption == 3) ? yellow : white);
 }
 
-void RenderGameOver(SDL_Renderer* renderer, TTF_Font* font, int score) {
+void RenderGameOver(SDL_Renderer* renderer, TTF_Font* font, int score, int best) {
     SDL_Color red = {255, 50, 50, 255};
     SDL_Color white = {255, 255, 255, 255};
     RenderText(renderer, font, "GAME OVER", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 - 20, red);
-    RenderText(renderer, font, "Your Score : " + std::to_string(score), SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 + 20, white);
+    char scoreText[32];
+    snprintf(scoreText, sizeof(scoreText), "Your Score : %d", score);
+    RenderText(renderer, font, scoreText, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 + 20, white);
+    if (best < 0) return;
+    SDL_Color yellow = {255, 255, 0, 255};
+    snprintf(scoreText, sizeof(scoreText), "Best : %d", best);
+    RenderText(renderer, font, scoreText, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 + 60, yellow);
 }
 
 void RenderScore(SDL_Renderer* renderer, TTF_Font* font, int score) {
     if (!renderer || !font) return; // safety check
 
+    const resources::GlyphAtlas* atlas = resources::GetGlyphAtlas(renderer, font);
+    if (!atlas) return;
     SDL_Color white = {255, 255, 255, 255};
-    std::string scoreText = "Score: " + std::to_string(score);
-
-    SDL_Surface* scoreSurface = TTF_RenderText_Blended(font, scoreText.c_str(), white);
-    if (scoreSurface) {
-        SDL_Texture* scoreTexture = SDL_CreateTextureFromSurface(renderer, scoreSurface);
-        if (scoreTexture) {
-            SDL_Rect scoreRect;
-            scoreRect.x = 10; // top-left x
-            scoreRect.y = 10; // top-left y
-            scoreRect.w = scoreSurface->w;
-            scoreRect.h = scoreSurface->h;
-            SDL_RenderCopy(renderer, scoreTexture, nullptr, &scoreRect);
-            SDL_DestroyTexture(scoreTexture);
-        }
-        SDL_FreeSurface(scoreSurface);
-    }
+    char scoreText[32];    // formatted on the stack, the score is drawn every frame
+    snprintf(scoreText, sizeof(scoreText), "Score: %d", score);
+    DrawHudLine(renderer, atlas, hud_lines[0], scoreText, 10, false, white); // top-left corner
+}
+
+void RenderVersusScores(SDL_Renderer* renderer, TTF_Font* font, int score1, int score2) {
+    if (!renderer || !font) return;
+
+    const resources::GlyphAtlas* atlas = resources::GetGlyphAtlas(renderer, font);
+    if (!atlas) return;
+    SDL_Color white = {255, 255, 255, 255};
+    char scoreText[32];
+    snprintf(scoreText, sizeof(scoreText), "P1: %d", score1);
+    DrawHudLine(renderer, atlas, hud_lines[0], scoreText, 10, false, white);   // top-left corner
+    snprintf(scoreText, sizeof(scoreText), "P2: %d", score2);
+    DrawHudLine(renderer, atlas, hud_lines[1], scoreText, SCREEN_WIDTH - 10, true, white);
+}
+
+void RenderVersusGameOver(SDL_Renderer* renderer, TTF_Font* font, int winner) {
+    SDL_Color red = {255, 50, 50, 255};
+    SDL_Color white = {255, 255, 255, 255};
+    RenderText(renderer, font, "GAME OVER", SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 - 20, red);
+    char winnerText[32];
+    if (winner < 0) snprintf(winnerText, sizeof(winnerText), "Draw!");
+    else snprintf(winnerText, sizeof(winnerText), "Player %d wins!", winner + 1);
+    RenderText(renderer, font, winnerText, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 + 20, white);
 }
@@ -61,17 +61,26 @@ extern const int SCREEN_HEIGHT;
 extern const char* FONT_PATH;
 // FIFO to read BLE values written by Python BLE client
 extern const char* FIFO_PATH;
-extern std::ifstream fifo_stream;
-extern std::string line;
-extern Joystick joy;
-extern bool joy_action;
-extern std::mutex joy_mutex;
 
 void printFPS();
-void read_joystick();
-void RenderText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color);
+void PrintFrameStats();
+void FrameDelay(Uint32 ms);
+void FrameDelayUs(Uint64 periodUs);
+// refresh of the vsync'd display, 0 when presents are not synced (headless)
+void SetDisplayRefresh(int hz);
+// the present interval: the loop's FrameDelay period, or the refresh period if that is longer;
+// what the governor and the auto render scale measure frames against
+double FrameBudgetSeconds();
+void RenderText(SDL_Renderer* renderer, TTF_Font* font, const char* text, int x, int y, SDL_Color color);
 void RenderMenu(SDL_Renderer* renderer, TTF_Font* font, int selectedOption);
-void RenderGameOver(SDL_Renderer* renderer, TTF_Font* font, int score);
+// best < 0 leaves out the high score line
+void RenderGameOver(SDL_Renderer* renderer, TTF_Font* font, int score, int best = -1);
 void RenderScore(SDL_Renderer* renderer, TTF_Font* font, int score);
+// versus modes: both scores along the top, and the winner (-1 for a draw) after the match
+void RenderVersusScores(SDL_Renderer* renderer, TTF_Font* font, int score1, int score2);
+void RenderVersusGameOver(SDL_Renderer* renderer, TTF_Font* font, int winner);
+// textures the score lines are cached in while the governor throttles the HUD
+void InitHud(SDL_Renderer* renderer);
+void ShutdownHud();
 
 #endif 
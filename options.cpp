@@ -0,0 +1,110 @@
+#include "options.h"
+#include "journal.h"
+#include "menu.h"
+#include "telemetry.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+Options options = {false, nullptr, 0, telemetry::DEFAULT_SOCKET_PATH, logger::Level::INFO, false, -1, -1, 0, false, {}, 0, nullptr, 1, 1.0f, false, true, false, 60, nullptr};
+
+static const int MIN_SIM_HZ = 20;
+static const int MAX_SIM_HZ = 240;
+
+static void PrintUsage(const char* program) {
+    std::cerr << "usage: " << program << " [options]\n"
+              << "  --headless        run without a visible window using the software renderer\n"
+              << "  --fifo PATH       BLE controller FIFO; repeat for more players (default: " << FIFO_PATH << ", up to "
+              << MAX_INPUT_CHANNELS << ")\n"
+              << "  --replay FILE     feed scripted input from FILE instead of the BLE FIFO\n"
+              << "  --seed N          fixed seed for spear spawning (default: clock, 1 with --replay)\n"
+              << "  --stats-socket P  unix datagram socket the stats record is sent to (default: "
+              << telemetry::DEFAULT_SOCKET_PATH << ")\n"
+              << "  --log-level L     debug, info, warn, error or off (default: info; SIGUSR1/SIGUSR2 adjust it live)\n"
+              << "  --assert-zero-alloc  exit with status 2 if a PLAYING frame allocates (build with make alloc-check)\n"
+              << "  --realtime        shorthand for --render-cpu 2 --input-cpu 3 --rt-priority 50 --mlock\n"
+              << "  --render-cpu N    pin the render thread to core N\n"
+              << "  --input-cpu N     pin the BLE FIFO reader to core N\n"
+              << "  --rt-priority N   SCHED_FIFO priority for the render thread (input gets N+1)\n"
+              << "  --mlock           lock the process in memory to avoid page-fault stalls\n"
+              << "  --capture FILE    record presented frames to FILE as a stream of QOI images\n"
+              << "  --capture-every N record one frame in N (default: 1)\n"
+              << "  --render-scale S  draw the arena at scale S (1, 0.75, 0.5 or 0.375) and upscale it; auto lowers\n"
+              << "                    the scale while frames run over budget (default: 1)\n"
+              << "  --scale-filter F  nearest or linear upscaling (default: nearest)\n"
+              << "  --no-governor     keep full render detail even when frames run over budget\n"
+              << "  --renderer R      sdl draws the arena with SDL primitives, sw with the vectorized software\n"
+              << "                    rasterizer into one streaming texture (default: sdl)\n"
+              << "  --sim-hz N        simulation ticks per second, " << MIN_SIM_HZ << " to " << MAX_SIM_HZ
+              << " and at most the display refresh; spears keep their speed per second (default: 60)\n"
+              << "  --journal FILE    session journal and high-score table (default: " << journal::DEFAULT_PATH
+              << ", none with --headless)\n"
+              << "  --no-journal      keep no record of sessions\n";
+}
+
+// "auto" or a scale in (0, 1]
+static bool ParseScale(const char* text, float& scale) {
+    if (!strcmp(text, "auto")) {
+        scale = 0;
+        return true;
+    }
+    char* end;
+    float value = strtof(text, &end);
+    if (*end || value <= 0 || value > 1) return false;
+    scale = value;
+    return true;
+}
+
+bool ParseOptions(int argc, char* argv[]) {
+    bool journal = true;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--headless")) options.headless = true;
+        else if (!strcmp(argv[i], "--fifo") && hasValue && options.fifoCount < MAX_INPUT_CHANNELS) {
+            options.fifoPaths[options.fifoCount++] = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--replay") && hasValue) options.replayPath = argv[++i];
+        else if (!strcmp(argv[i], "--stats-socket") && hasValue) options.statsSocket = argv[++i];
+        else if (!strcmp(argv[i], "--seed") && hasValue) options.seed = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+        else if (!strcmp(argv[i], "--assert-zero-alloc")) options.assertZeroAlloc = true;
+        else if (!strcmp(argv[i], "--realtime")) {
+            // the Pi 3 has four cores; leave 0 and 1 to the BLE bridge and the system
+            options.renderCpu = 2;
+            options.inputCpu = 3;
+            options.rtPriority = 50;
+            options.lockMemory = true;
+        }
+        else if (!strcmp(argv[i], "--render-cpu") && hasValue) options.renderCpu = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--input-cpu") && hasValue) options.inputCpu = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--rt-priority") && hasValue) options.rtPriority = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--mlock")) options.lockMemory = true;
+        else if (!strcmp(argv[i], "--capture") && hasValue) options.capturePath = argv[++i];
+        else if (!strcmp(argv[i], "--capture-every") && hasValue && atoi(argv[i + 1]) > 0) options.captureEvery = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--render-scale") && hasValue && ParseScale(argv[i + 1], options.renderScale)) i++;
+        else if (!strcmp(argv[i], "--scale-filter") && hasValue && (!strcmp(argv[i + 1], "nearest") || !strcmp(argv[i + 1], "linear"))) {
+            options.linearScale = !strcmp(argv[++i], "linear");
+        }
+        else if (!strcmp(argv[i], "--no-governor")) options.governor = false;
+        else if (!strcmp(argv[i], "--renderer") && hasValue && (!strcmp(argv[i + 1], "sw") || !strcmp(argv[i + 1], "sdl"))) {
+            options.softwareRaster = !strcmp(argv[++i], "sw");
+        }
+        else if (!strcmp(argv[i], "--sim-hz") && hasValue && atoi(argv[i + 1]) >= MIN_SIM_HZ && atoi(argv[i + 1]) <= MAX_SIM_HZ) {
+            options.simHz = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--journal") && hasValue) options.journalPath = argv[++i];
+        else if (!strcmp(argv[i], "--no-journal")) journal = false;
+        else if (!strcmp(argv[i], "--log-level") && hasValue && logger::ParseLevel(argv[i + 1], options.logLevel)) i++;
+        else {
+            PrintUsage(argv[0]);
+            return false;
+        }
+    }
+    // a replay is only reproducible if the spawner is too
+    if (options.replayPath && options.seed == 0) options.seed = 1;
+    // replays and PGO training are not sessions worth keeping
+    if (!journal) options.journalPath = nullptr;
+    else if (!options.journalPath && !options.headless) options.journalPath = journal::DEFAULT_PATH;
+    if (options.fifoCount == 0) options.fifoPaths[options.fifoCount++] = FIFO_PATH;
+    logger::SetLevel(options.logLevel);
+    return true;
+}
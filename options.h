@@ -0,0 +1,39 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include "logger.h"
+
+// BLE controllers, each with its own FIFO; channel N drives player N
+const int MAX_INPUT_CHANNELS = 4;
+
+// command line options shared by main and the games
+struct Options {
+    bool headless;              // dummy video driver + software renderer, no frame delays
+    const char* replayPath;     // scripted input instead of the BLE FIFO
+    unsigned int seed;          // 0 seeds the spear spawner from the clock
+    const char* statsSocket;    // where the once-per-second stats record is sent
+    logger::Level logLevel;
+    bool assertZeroAlloc;       // fail the run if a PLAYING frame allocates (needs -DTRACK_ALLOCATIONS)
+    // real-time mode, see realtime.h; -1 / 0 leave the scheduler's defaults
+    int renderCpu;
+    int inputCpu;
+    int rtPriority;             // SCHED_FIFO priority of the render thread, input gets one more
+    bool lockMemory;
+    const char* fifoPaths[MAX_INPUT_CHANNELS];  // --fifo, repeatable; FIFO_PATH when none is given
+    int fifoCount;
+    const char* capturePath;    // record gameplay as a QOI stream, see capture.h
+    int captureEvery;           // capture one frame in N
+    float renderScale;          // internal scale of the arena, 0 = automatic, see render_scale.h
+    bool linearScale;           // linear instead of nearest filtering when upscaling
+    bool governor;              // trade render detail for frame time under load, see governor.h
+    bool softwareRaster;        // --renderer sw: world drawn by softraster.h instead of SDL primitives
+    int simHz;                  // simulation ticks per second, see sim.h
+    const char* journalPath;    // session journal and high scores, see journal.h; nullptr when off
+};
+
+extern Options options;
+
+// returns false (after printing usage) on an unknown or incomplete option
+bool ParseOptions(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,166 @@
+#include "particles.h"
+#include "logger.h"
+#include "telemetry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    typedef float F32x4 __attribute__((vector_size(16)));
+    const int LANES = 4;
+
+    const float GRAVITY = 400.0f;       // px/s^2, sparks fall a little
+    const float DRAG = 2.5f;            // 1/s
+    const float FADE_TIME = 0.25f;      // seconds of fading out at the end of a life
+    const float HALF_SIZE = 1.5f;       // each particle is a 3 px quad
+
+    // struct of arrays, live particles packed at the front
+    alignas(16) float pos_x[particles::MAX_PARTICLES];
+    alignas(16) float pos_y[particles::MAX_PARTICLES];
+    alignas(16) float vel_x[particles::MAX_PARTICLES];
+    alignas(16) float vel_y[particles::MAX_PARTICLES];
+    alignas(16) float life[particles::MAX_PARTICLES];
+    SDL_Color colors[particles::MAX_PARTICLES];
+    int live = 0;
+
+    // one quad per particle, the index pattern is the same every frame
+    SDL_Vertex vertices[particles::MAX_PARTICLES * 4];
+    int indices[particles::MAX_PARTICLES * 6];
+    bool indices_built = false;
+
+    particles::ParticleStats stats = {};
+
+    // the game's rand() drives the spear spawner and has to stay reproducible for replays
+    uint32_t rng_state = 0x9e3779b9u;
+
+    float Random01() {
+        rng_state ^= rng_state << 13;
+        rng_state ^= rng_state >> 17;
+        rng_state ^= rng_state << 5;
+        return (rng_state >> 8) * (1.0f / 16777216.0f);
+    }
+
+    inline F32x4 Load(const float* at) {
+        F32x4 value;
+        memcpy(&value, at, sizeof(value));
+        return value;
+    }
+
+    inline void Store(float* at, F32x4 value) {
+        memcpy(at, &value, sizeof(value));
+    }
+
+    void BuildIndices() {
+        for (int i = 0; i < particles::MAX_PARTICLES; i++) {
+            int* quad = indices + i * 6;
+            int base = i * 4;
+            quad[0] = base; quad[1] = base + 1; quad[2] = base + 2;
+            quad[3] = base + 2; quad[4] = base + 3; quad[5] = base;
+        }
+        indices_built = true;
+    }
+}
+
+namespace particles {
+    void EmitBurst(float x, float y, int count, SDL_Color color, float speed, float lifetime) {
+        int room = MAX_PARTICLES - live;
+        if (count > room) {
+            stats.dropped += count - room;
+            count = room;
+        }
+        for (int n = 0; n < count; n++) {
+            int i = live++;
+            float angle = Random01() * 6.2831853f;
+            float velocity = speed * (0.3f + 0.7f * Random01());
+            pos_x[i] = x;
+            pos_y[i] = y;
+            vel_x[i] = std::cos(angle) * velocity;
+            vel_y[i] = std::sin(angle) * velocity;
+            life[i] = lifetime * (0.5f + 0.5f * Random01());
+            colors[i] = color;
+        }
+        stats.emitted += count;
+        stats.peakLive = std::max(stats.peakLive, live);
+    }
+
+    void EmitBlock(float x, float y) {
+        EmitBurst(x, y, 24, {0, 180, 255, 255}, 220.0f, 0.5f);     // spear blue
+        EmitBurst(x, y, 12, {230, 230, 230, 255}, 160.0f, 0.4f);   // shield sparks
+    }
+
+    void EmitHit(float x, float y) {
+        EmitBurst(x, y, 96, {255, 50, 50, 255}, 300.0f, 1.0f);
+    }
+
+    void UpdateParticles(float dt) {
+        if (live == 0) return;
+        // whole vectors up to the last live particle; lanes past it are scratch
+        const F32x4 step = {dt, dt, dt, dt};
+        const F32x4 damping = F32x4{1, 1, 1, 1} - DRAG * dt;
+        const F32x4 fall = step * GRAVITY;
+        for (int i = 0; i < live; i += LANES) {
+            F32x4 vx = Load(vel_x + i) * damping;
+            F32x4 vy = Load(vel_y + i) * damping + fall;
+            Store(vel_x + i, vx);
+            Store(vel_y + i, vy);
+            Store(pos_x + i, Load(pos_x + i) + vx * step);
+            Store(pos_y + i, Load(pos_y + i) + vy * step);
+            Store(life + i, Load(life + i) - step);
+        }
+
+        // compact: the last live particle takes the place of each dead one
+        for (int i = 0; i < live;) {
+            if (life[i] > 0) {
+                i++;
+                continue;
+            }
+            int last = --live;
+            pos_x[i] = pos_x[last];
+            pos_y[i] = pos_y[last];
+            vel_x[i] = vel_x[last];
+            vel_y[i] = vel_y[last];
+            life[i] = life[last];
+            colors[i] = colors[last];
+        }
+    }
+
+    void RenderParticles(SDL_Renderer* renderer) {
+        if (live == 0) return;
+        if (!indices_built) BuildIndices();
+        for (int i = 0; i < live; i++) {
+            SDL_Color color = colors[i];
+            color.a = static_cast<Uint8>(255 * std::min(1.0f, life[i] / FADE_TIME));
+            SDL_Vertex* quad = vertices + i * 4;
+            float left = pos_x[i] - HALF_SIZE, right = pos_x[i] + HALF_SIZE;
+            float top = pos_y[i] - HALF_SIZE, bottom = pos_y[i] + HALF_SIZE;
+            quad[0].position = {left, top};
+            quad[1].position = {right, top};
+            quad[2].position = {right, bottom};
+            quad[3].position = {left, bottom};
+            for (int v = 0; v < 4; v++) quad[v].color = color;
+        }
+
+        SDL_BlendMode previous;
+        SDL_GetRenderDrawBlendMode(renderer, &previous);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        SDL_RenderGeometry(renderer, nullptr, vertices, live * 4, indices, live * 6);
+        SDL_SetRenderDrawBlendMode(renderer, previous);
+        telemetry::CountDrawCalls(1);
+    }
+
+    void ClearParticles() {
+        live = 0;
+    }
+
+    ParticleStats GetParticleStats() {
+        ParticleStats result = stats;
+        result.live = live;
+        return result;
+    }
+
+    void PrintParticleStats() {
+        if (stats.emitted == 0) return;
+        logger::Info("Particles: %u emitted, %u dropped (pool full), peak %d of %d live",
+                     stats.emitted, stats.dropped, stats.peakLive, MAX_PARTICLES);
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <SDL2/SDL.h>
+#include <stdint.h>
+
+// spark effects for blocked spears and hits: one preallocated struct-of-arrays pool, integrated
+// four particles at a time and drawn with a single SDL_RenderGeometry call
+// nothing here touches the heap; bursts that do not fit in the pool are cut short and counted
+namespace particles {
+    const int MAX_PARTICLES = 4096;     // multiple of the vector width
+
+    struct ParticleStats {
+        uint64_t emitted;
+        uint64_t dropped;   // pool full
+        int live;
+        int peakLive;
+    };
+
+    // count particles flying out of (x, y) at up to speed px/s, living up to lifetime seconds
+    void EmitBurst(float x, float y, int count, SDL_Color color, float speed, float lifetime);
+    // the two effects the games use
+    void EmitBlock(float x, float y);
+    void EmitHit(float x, float y);
+
+    // once per simulation tick, dt = sim::TickSeconds()
+    void UpdateParticles(float dt);
+    // drawn over the world at native resolution, before the HUD
+    void RenderParticles(SDL_Renderer* renderer);
+    void ClearParticles();
+
+    ParticleStats GetParticleStats();
+    void PrintParticleStats();
+}
+
+#endif
@@ -0,0 +1,158 @@
+#include "realtime.h"
+#include "input.h"
+#include "logger.h"
+#include "options.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <time.h>
+
+namespace {
+    const int LATE_BUCKETS = 24;            // power-of-two buckets, the last one is 2^23 us and above
+    const size_t STACK_PREFAULT = 256 * 1024;
+
+    struct ThreadStatus {
+        bool configured;
+        bool pinned;
+        int priority;       // SCHED_FIFO priority actually applied, 0 for SCHED_OTHER
+    };
+
+    ThreadStatus thread_status[2] = {};
+    cpu_set_t process_cpus;     // affinity before the render thread was pinned
+    bool memory_locked = false;
+
+    // render thread only; telemetry publishes from the render thread too
+    realtime::WakeStats wake_stats = {};
+    realtime::WakeStats interval_stats = {};
+    uint64_t late_histogram[LATE_BUCKETS] = {};
+
+    int Bucket(uint64_t lateUs) {
+        int bucket = 0;
+        while (lateUs > 1 && bucket < LATE_BUCKETS - 1) {
+            lateUs >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+
+    // touch the stack now so a deep call during a frame does not take a page fault
+    void PrefaultStack() {
+        volatile char stack[STACK_PREFAULT];
+        for (size_t i = 0; i < STACK_PREFAULT; i += 4096) stack[i] = 0;
+        (void)stack[0];
+    }
+
+    int CpuFor(realtime::Role role) {
+        return role == realtime::Role::RENDER ? options.renderCpu : options.inputCpu;
+    }
+
+    // input runs just above render: it only wakes briefly and should never wait behind a frame
+    int PriorityFor(realtime::Role role) {
+        if (options.rtPriority <= 0) return 0;
+        int priority = options.rtPriority + (role == realtime::Role::INPUT ? 1 : 0);
+        return std::min(priority, sched_get_priority_max(SCHED_FIFO));
+    }
+
+    const char* RoleName(realtime::Role role) {
+        return role == realtime::Role::RENDER ? "render" : "input";
+    }
+}
+
+namespace realtime {
+    void InitRealtime() {
+        if (options.lockMemory) {
+            // on fault: a thread started later (the BLE reader, SDL's) would otherwise lock its
+            // whole default stack up front, which can exhaust RLIMIT_MEMLOCK and fail its creation
+            if (mlockall(MCL_CURRENT | MCL_FUTURE | MCL_ONFAULT) == 0) {
+                memory_locked = true;
+                PrefaultStack();
+            }
+            else logger::Warn("mlockall failed (%s), running with pageable memory", strerror(errno));
+        }
+        sched_getaffinity(0, sizeof(process_cpus), &process_cpus);
+        ConfigureThread(Role::RENDER);
+    }
+
+    void ConfigureThread(Role role) {
+        int cpu = CpuFor(role);
+        int priority = PriorityFor(role);
+        // a thread started by a pinned render thread inherits its core; give it the rest back
+        if (cpu < 0 && role != Role::RENDER && thread_status[static_cast<int>(Role::RENDER)].pinned) {
+            pthread_setaffinity_np(pthread_self(), sizeof(process_cpus), &process_cpus);
+        }
+        if (cpu < 0 && priority == 0) return;   // real-time mode is off for this thread
+        ThreadStatus& status = thread_status[static_cast<int>(role)];
+        status.configured = true;
+
+        if (cpu >= 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            if (error == 0) status.pinned = true;
+            else logger::Warn("Could not pin %s thread to cpu %d: %s", RoleName(role), cpu, strerror(error));
+        }
+
+        if (priority == 0) return;
+        sched_param param = {};
+        param.sched_priority = priority;
+        int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (error == 0) status.priority = priority;
+        else {
+            logger::Warn("SCHED_FIFO %d unavailable for %s thread (%s), staying on SCHED_OTHER", priority, RoleName(role),
+                         error == EPERM ? "needs CAP_SYS_NICE or an rtprio limit" : strerror(error));
+        }
+    }
+
+    void SleepUntil(uint64_t targetUs) {
+        timespec target;
+        target.tv_sec = static_cast<time_t>(targetUs / 1000000);
+        target.tv_nsec = static_cast<long>(targetUs % 1000000) * 1000;
+        // input::NowUs() is steady_clock, which is CLOCK_MONOTONIC on Linux
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr) == EINTR) {}
+
+        uint64_t now = input::NowUs();
+        uint64_t late = now > targetUs ? now - targetUs : 0;
+        for (WakeStats* stats : {&wake_stats, &interval_stats}) {
+            stats->wakes++;
+            stats->totalLateUs += late;
+            if (late > stats->maxLateUs) stats->maxLateUs = late;
+        }
+        late_histogram[Bucket(late)]++;
+    }
+
+    WakeStats GetWakeStats() {
+        return wake_stats;
+    }
+
+    WakeStats TakeIntervalWakeStats() {
+        WakeStats stats = interval_stats;
+        interval_stats = {};
+        return stats;
+    }
+
+    void PrintRealtimeStats() {
+        for (int i = 0; i < 2; i++) {
+            const ThreadStatus& status = thread_status[i];
+            if (!status.configured) continue;
+            Role role = static_cast<Role>(i);
+            if (status.pinned) logger::Info("Realtime: %s thread pinned to cpu %d", RoleName(role), CpuFor(role));
+            if (status.priority > 0) logger::Info("Realtime: %s thread on SCHED_FIFO %d", RoleName(role), status.priority);
+        }
+        if (options.lockMemory) logger::Info("Realtime: memory %s", memory_locked ? "locked" : "not locked");
+
+        if (wake_stats.wakes == 0) return;
+        // upper edge of the bucket holding the 99th percentile
+        uint64_t threshold = wake_stats.wakes - wake_stats.wakes / 100, seen = 0;
+        int bucket = 0;
+        for (; bucket < LATE_BUCKETS - 1; bucket++) {
+            seen += late_histogram[bucket];
+            if (seen >= threshold) break;
+        }
+        logger::Info("Frame wake lateness: %u wakes, avg %u us, p99 < %u us, max %u us", wake_stats.wakes,
+                     wake_stats.totalLateUs / wake_stats.wakes, 2ull << bucket, wake_stats.maxLateUs);
+    }
+}
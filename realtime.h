@@ -0,0 +1,36 @@
+#ifndef REALTIME_H
+#define REALTIME_H
+
+#include <stdint.h>
+
+// optional real-time mode for the Pi: pins the render and input threads to their own cores,
+// gives them SCHED_FIFO priorities and locks the process in memory; each step that lacks
+// privilege is logged once and skipped, so the game still runs as a normal process
+// the render thread's wake lateness is measured whether or not the mode is on, for comparison
+namespace realtime {
+    enum class Role {
+        RENDER,
+        INPUT
+    };
+
+    struct WakeStats {
+        uint64_t wakes;
+        uint64_t totalLateUs;
+        uint64_t maxLateUs;
+    };
+
+    // render thread, once startup work is done: mlockall and the render thread's own settings
+    // threads started afterwards inherit them until they call ConfigureThread themselves
+    void InitRealtime();
+    void ConfigureThread(Role role);
+
+    // sleep until targetUs on the input::NowUs() clock and record how late the wake-up was
+    void SleepUntil(uint64_t targetUs);
+
+    WakeStats GetWakeStats();
+    // wake stats since the previous call, for the once-per-second stats record
+    WakeStats TakeIntervalWakeStats();
+    void PrintRealtimeStats();
+}
+
+#endif
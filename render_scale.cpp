@@ -0,0 +1,147 @@
+#include "render_scale.h"
+#include "governor.h"
+#include "logger.h"
+#include "menu.h"
+#include "options.h"
+#include "softraster.h"
+#include "telemetry.h"
+
+namespace {
+    // fractions of the frame budget, the present interval (FrameBudgetSeconds)
+    const double OVER_BUDGET = 1.1;                     // average above this steps the scale down
+    const double UNDER_BUDGET = 0.7;                    // frame work expected below this at the next scale up steps back up
+    const int WINDOW_FRAMES = 30;                       // frames averaged per decision
+
+    SDL_Texture* world = nullptr;
+    int level = 0;
+    bool in_world = false;
+
+    // auto mode
+    double window_time = 0;
+    double window_work = 0;     // without vsync / FrameDelay padding, see governor::FrameWorkSeconds
+    int window_frames = 0;
+
+    render_scale::ScaleStats stats = {};
+
+    // fixed scales round up to the nearest level; auto starts at full scale
+    int LevelFor(float scale) {
+        if (scale <= 0) return 0;
+        int best = 0;
+        for (int i = 1; i < render_scale::NUM_LEVELS; i++) {
+            if (render_scale::LEVELS[i] >= scale - 0.001f) best = i;
+        }
+        return best;
+    }
+
+    const char* ModeName() {
+        return options.renderScale == 0 ? "auto" : "fixed";
+    }
+}
+
+namespace render_scale {
+    bool InitRenderScale(SDL_Renderer* renderer) {
+        level = LevelFor(options.renderScale);
+        // a fixed scale of 1 needs no texture at all
+        if (options.renderScale == 1.0f) return true;
+        if (options.softwareRaster) {
+            logger::Warn("--render-scale is ignored with --renderer sw");
+            level = 0;
+            return false;
+        }
+
+        if (!SDL_RenderTargetSupported(renderer)) {
+            logger::Warn("Renderer has no render targets, --render-scale ignored");
+            level = 0;
+            return false;
+        }
+        world = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, SCREEN_WIDTH, SCREEN_HEIGHT);
+        if (!world) {
+            logger::Warn("Could not create the world texture (%s), --render-scale ignored", SDL_GetError());
+            level = 0;
+            return false;
+        }
+        SDL_SetTextureBlendMode(world, SDL_BLENDMODE_NONE);
+        SDL_SetTextureScaleMode(world, options.linearScale ? SDL_ScaleModeLinear : SDL_ScaleModeNearest);
+        logger::Info("Render scale %s, starting at %.3f (%s filtering)", ModeName(), LEVELS[level],
+                     options.linearScale ? "linear" : "nearest");
+        return true;
+    }
+
+    void ShutdownRenderScale() {
+        if (world) SDL_DestroyTexture(world);
+        world = nullptr;
+    }
+
+    void BeginWorld(SDL_Renderer* renderer) {
+        // the software rasterizer is its own full-size world target
+        if (softraster::BeginFrame(renderer)) return;
+        // at full scale draw straight to the window, the copy would only cost fill rate
+        if (!world || level == 0) return;
+        in_world = true;
+        SDL_SetRenderTarget(renderer, world);
+        // game coordinates stay unchanged, the renderer maps them into the scaled corner
+        SDL_RenderSetScale(renderer, LEVELS[level], LEVELS[level]);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+    }
+
+    void EndWorld(SDL_Renderer* renderer) {
+        if (softraster::Active()) {
+            softraster::EndFrame(renderer);
+            return;
+        }
+        if (!in_world) return;
+        in_world = false;
+        // switching back restores the window's own viewport and scale
+        SDL_SetRenderTarget(renderer, nullptr);
+        SDL_Rect source = {0, 0, static_cast<int>(SCREEN_WIDTH * LEVELS[level]), static_cast<int>(SCREEN_HEIGHT * LEVELS[level])};
+        SDL_RenderCopy(renderer, world, &source, nullptr);
+        telemetry::CountDrawCalls(1);
+    }
+
+    void UpdateAutoScale(double frameSeconds) {
+        stats.framesAtLevel[level]++;
+        if (options.renderScale != 0 || !world) return;
+
+        window_time += frameSeconds;
+        window_work += governor::FrameWorkSeconds();
+        if (++window_frames < WINDOW_FRAMES) return;
+        double average = window_time / window_frames;
+        double work = window_work / window_frames;
+        window_time = 0;
+        window_work = 0;
+        window_frames = 0;
+
+        // missed frames show in the frame time; headroom only shows in the unpadded work, since
+        // vsync and FrameDelay stretch every frame to the budget. Stepping up is judged on the
+        // work grown by the extra pixels of the next scale, so it does not bounce straight back
+        int next = level;
+        double budget = FrameBudgetSeconds();
+        if (average > budget * OVER_BUDGET && level < NUM_LEVELS - 1) next = level + 1;
+        else if (level > 0) {
+            double growth = LEVELS[level - 1] / LEVELS[level];
+            if (work * growth * growth < budget * UNDER_BUDGET) next = level - 1;
+        }
+        if (next == level) return;
+        logger::Info("Render scale %.3f -> %.3f (avg frame %.2f ms, work %.2f ms)", LEVELS[level], LEVELS[next],
+                     average * 1000.0, work * 1000.0);
+        level = next;
+        stats.changes++;
+    }
+
+    float CurrentScale() {
+        return LEVELS[level];
+    }
+
+    ScaleStats GetScaleStats() {
+        return stats;
+    }
+
+    void PrintScaleStats() {
+        if (options.renderScale == 1.0f) return;
+        logger::Info("Render scale (%s): %u changes, now %.3f", ModeName(), stats.changes, LEVELS[level]);
+        for (int i = 0; i < NUM_LEVELS; i++) {
+            if (stats.framesAtLevel[i]) logger::Info("  %.3f: %u frames", LEVELS[i], stats.framesAtLevel[i]);
+        }
+    }
+}
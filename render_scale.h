@@ -0,0 +1,35 @@
+#ifndef RENDER_SCALE_H
+#define RENDER_SCALE_H
+
+#include <SDL2/SDL.h>
+#include <stdint.h>
+
+// internal render scale for the arena (--render-scale): the game world is drawn into a smaller
+// target texture and stretched to the window, the HUD is drawn afterwards at native resolution
+// cuts fill rate on the Pi's GPU; at scale 1 the world is drawn straight to the window
+namespace render_scale {
+    const int NUM_LEVELS = 4;
+    const float LEVELS[NUM_LEVELS] = {1.0f, 0.75f, 0.5f, 0.375f};
+
+    struct ScaleStats {
+        uint64_t framesAtLevel[NUM_LEVELS];
+        uint64_t changes;       // automatic scale changes
+    };
+
+    // creates the target texture once at full size; lower scales use its top-left corner
+    bool InitRenderScale(SDL_Renderer* renderer);
+    void ShutdownRenderScale();
+
+    // wrap the world drawing (players, spears); everything after EndWorld is native resolution
+    void BeginWorld(SDL_Renderer* renderer);
+    void EndWorld(SDL_Renderer* renderer);
+
+    // once per frame with the frame time; in auto mode steps the scale down while over budget
+    void UpdateAutoScale(double frameSeconds);
+    float CurrentScale();
+
+    ScaleStats GetScaleStats();
+    void PrintScaleStats();
+}
+
+#endif
@@ -0,0 +1,272 @@
+#include "resources.h"
+#include "logger.h"
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>   // for font file size
+
+namespace {
+    struct FontEntry {
+        TTF_Font* font = nullptr;
+        int refs = 0;
+        size_t fileBytes = 0;
+        SDL_Surface* atlasSurface = nullptr;    // rasterized glyphs waiting for upload
+        resources::GlyphAtlas atlas = {};
+        SDL_Renderer* atlasRenderer = nullptr;  // renderer the atlas texture belongs to
+    };
+
+    struct TextureEntry {
+        SDL_Texture* texture = nullptr;
+        int refs = 0;
+        size_t bytes = 0;
+    };
+
+    typedef std::pair<std::string, int> FontKey;
+    typedef std::pair<SDL_Renderer*, std::string> TextureKey;
+
+    std::mutex cache_mutex;
+    std::map<FontKey, FontEntry> fonts;
+    std::map<TextureKey, TextureEntry> textures;
+    std::set<FontKey> pending_fonts;            // keys currently being loaded by a preload thread
+    std::vector<std::thread> preload_threads;
+    resources::ResourceStats stats = {};
+
+    double ElapsedMs(Uint64 start) {
+        return (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+    }
+
+    // rasterize printable ASCII into a single white surface, packed in rows
+    SDL_Surface* RasterizeGlyphs(TTF_Font* font, resources::GlyphAtlas& atlas) {
+        const int MAX_ROW_WIDTH = 512;
+        SDL_Color white = {255, 255, 255, 255};
+        SDL_Surface* glyphs[resources::NUM_GLYPHS] = {};
+        int penX = 0, penY = 0, rowHeight = 0, atlasWidth = 0;
+
+        atlas.height = TTF_FontHeight(font);
+        for (int i = 0; i < resources::NUM_GLYPHS; i++) {
+            Uint16 ch = static_cast<Uint16>(resources::FIRST_GLYPH + i);
+            int minx, maxx, miny, maxy, advance = 0;
+            if (TTF_GlyphMetrics(font, ch, &minx, &maxx, &miny, &maxy, &advance) != 0) advance = 0;
+            atlas.advance[i] = advance;
+            atlas.glyphs[i] = {0, 0, 0, 0};
+
+            glyphs[i] = TTF_RenderGlyph_Blended(font, ch, white);
+            if (!glyphs[i]) continue;
+            if (penX + glyphs[i]->w > MAX_ROW_WIDTH) {
+                penX = 0;
+                penY += rowHeight;
+                rowHeight = 0;
+            }
+            atlas.glyphs[i] = {penX, penY, glyphs[i]->w, glyphs[i]->h};
+            penX += glyphs[i]->w;
+            if (glyphs[i]->h > rowHeight) rowHeight = glyphs[i]->h;
+            if (penX > atlasWidth) atlasWidth = penX;
+        }
+
+        SDL_Surface* surface = nullptr;
+        if (atlasWidth > 0) {
+            surface = SDL_CreateRGBSurfaceWithFormat(0, atlasWidth, penY + rowHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+        }
+        if (surface) SDL_FillRect(surface, nullptr, SDL_MapRGBA(surface->format, 255, 255, 255, 0));
+        for (int i = 0; i < resources::NUM_GLYPHS; i++) {
+            if (!glyphs[i]) continue;
+            if (surface) {
+                // copy alpha as-is instead of blending onto the transparent atlas
+                SDL_SetSurfaceBlendMode(glyphs[i], SDL_BLENDMODE_NONE);
+                SDL_BlitSurface(glyphs[i], nullptr, surface, &atlas.glyphs[i]);
+            }
+            SDL_FreeSurface(glyphs[i]);
+        }
+        return surface;
+    }
+
+    // open a font and rasterize its glyphs; runs without holding the cache lock
+    FontEntry LoadFont(const FontKey& key, double& loadMs) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        FontEntry entry;
+        entry.font = TTF_OpenFont(key.first.c_str(), key.second);
+        if (entry.font) {
+            struct stat stat_buf;
+            if (stat(key.first.c_str(), &stat_buf) == 0) entry.fileBytes = static_cast<size_t>(stat_buf.st_size);
+            entry.atlasSurface = RasterizeGlyphs(entry.font, entry.atlas);
+        }
+        loadMs = ElapsedMs(start);
+        return entry;
+    }
+
+    // account for a freshly loaded font; caller holds cache_mutex
+    void InsertFont(const FontKey& key, const FontEntry& entry, double loadMs) {
+        fonts[key] = entry;
+        stats.fontsResident++;
+        stats.fontLoads++;
+        stats.fontLoadMs += loadMs;
+        stats.residentBytes += entry.fileBytes;
+        if (entry.atlasSurface) stats.residentBytes += static_cast<size_t>(entry.atlasSurface->w) * entry.atlasSurface->h * 4;
+    }
+
+    void CloseFont(FontEntry& entry) {
+        stats.fontsResident--;
+        stats.residentBytes -= entry.fileBytes;
+        if (entry.atlasSurface) {
+            stats.residentBytes -= static_cast<size_t>(entry.atlasSurface->w) * entry.atlasSurface->h * 4;
+            SDL_FreeSurface(entry.atlasSurface);
+        }
+        if (entry.atlas.texture) SDL_DestroyTexture(entry.atlas.texture);
+        TTF_CloseFont(entry.font);
+    }
+}
+
+namespace resources {
+    void PreloadFontAsync(const char* path, int size) {
+        FontKey key(path, size);
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            if (fonts.count(key) || pending_fonts.count(key)) return;
+            pending_fonts.insert(key);
+        }
+        preload_threads.emplace_back([key]() {
+            double loadMs = 0;
+            FontEntry entry = LoadFont(key, loadMs);
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            pending_fonts.erase(key);
+            if (entry.font) InsertFont(key, entry, loadMs);
+            else logger::Error("Failed to preload font %s: %s", key.first, TTF_GetError());
+        });
+    }
+
+    void WaitForPreload() {
+        for (auto& thread : preload_threads) {
+            if (thread.joinable()) thread.join();
+        }
+        preload_threads.clear();
+    }
+
+    TTF_Font* AcquireFont(const char* path, int size) {
+        FontKey key(path, size);
+        bool waitForPreload = false;
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            auto it = fonts.find(key);
+            if (it != fonts.end()) {
+                it->second.refs++;
+                stats.fontHits++;
+                return it->second.font;
+            }
+            waitForPreload = pending_fonts.count(key) > 0;
+        }
+        if (waitForPreload) {
+            WaitForPreload();
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            auto it = fonts.find(key);
+            if (it == fonts.end()) return nullptr;  // preload already failed
+            it->second.refs++;
+            stats.fontHits++;
+            return it->second.font;
+        }
+
+        double loadMs = 0;
+        FontEntry entry = LoadFont(key, loadMs);
+        if (!entry.font) return nullptr;
+        entry.refs = 1;
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        InsertFont(key, entry, loadMs);
+        return entry.font;
+    }
+
+    void ReleaseFont(TTF_Font* font) {
+        if (!font) return;
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        for (auto it = fonts.begin(); it != fonts.end(); ++it) {
+            if (it->second.font != font) continue;
+            if (--it->second.refs <= 0) {
+                CloseFont(it->second);
+                fonts.erase(it);
+            }
+            return;
+        }
+    }
+
+    const GlyphAtlas* GetGlyphAtlas(SDL_Renderer* renderer, TTF_Font* font) {
+        if (!renderer || !font) return nullptr;
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        for (auto& item : fonts) {
+            FontEntry& entry = item.second;
+            if (entry.font != font) continue;
+            if (entry.atlas.texture && entry.atlasRenderer == renderer) return &entry.atlas;
+            if (!entry.atlasSurface) return nullptr;
+            // upload on first use; the surface is kept so another renderer can get its own copy
+            if (entry.atlas.texture) SDL_DestroyTexture(entry.atlas.texture);
+            entry.atlas.texture = SDL_CreateTextureFromSurface(renderer, entry.atlasSurface);
+            if (!entry.atlas.texture) return nullptr;
+            SDL_SetTextureBlendMode(entry.atlas.texture, SDL_BLENDMODE_BLEND);
+            entry.atlasRenderer = renderer;
+            return &entry.atlas;
+        }
+        return nullptr;
+    }
+
+    SDL_Texture* AcquireTexture(SDL_Renderer* renderer, const std::string& key, const std::function<SDL_Surface*()>& generate) {
+        TextureKey textureKey(renderer, key);
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        auto it = textures.find(textureKey);
+        if (it != textures.end()) {
+            it->second.refs++;
+            stats.textureHits++;
+            return it->second.texture;
+        }
+
+        Uint64 start = SDL_GetPerformanceCounter();
+        SDL_Surface* surface = generate();
+        if (!surface) return nullptr;
+        TextureEntry entry;
+        entry.texture = SDL_CreateTextureFromSurface(renderer, surface);
+        entry.bytes = static_cast<size_t>(surface->w) * surface->h * 4;
+        SDL_FreeSurface(surface);
+        if (!entry.texture) return nullptr;
+        entry.refs = 1;
+        textures[textureKey] = entry;
+
+        stats.texturesResident++;
+        stats.textureLoads++;
+        stats.textureLoadMs += ElapsedMs(start);
+        stats.residentBytes += entry.bytes;
+        return entry.texture;
+    }
+
+    void ReleaseTexture(SDL_Renderer* renderer, const std::string& key) {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        auto it = textures.find(TextureKey(renderer, key));
+        if (it == textures.end()) return;
+        if (--it->second.refs <= 0) {
+            SDL_DestroyTexture(it->second.texture);
+            stats.texturesResident--;
+            stats.residentBytes -= it->second.bytes;
+            textures.erase(it);
+        }
+    }
+
+    ResourceStats GetResourceStats() {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        return stats;
+    }
+
+    void PrintResourceStats() {
+        ResourceStats s = GetResourceStats();
+        logger::Info("Resources: %d fonts (%d loads, %d hits, %.2f ms), %d textures (%d loads, %d hits, %.2f ms), %u KiB resident",
+                     s.fontsResident, s.fontLoads, s.fontHits, s.fontLoadMs, s.texturesResident, s.textureLoads,
+                     s.textureHits, s.textureLoadMs, s.residentBytes / 1024);
+    }
+
+    void ShutdownResources() {
+        WaitForPreload();
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        for (auto& item : textures) SDL_DestroyTexture(item.second.texture);
+        textures.clear();
+        for (auto& item : fonts) CloseFont(item.second);
+        fonts.clear();
+        stats.texturesResident = 0;
+        stats.residentBytes = 0;
+    }
+}
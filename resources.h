@@ -0,0 +1,58 @@
+#ifndef RESOURCES_H
+#define RESOURCES_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <functional>
+#include <string>
+
+// process-wide, reference-counted cache for fonts, their glyph atlases and generated textures
+// fonts are opened once and shared by the menu and both games instead of reopened on every entry
+namespace resources {
+    const int FIRST_GLYPH = 32;     // ' '
+    const int LAST_GLYPH = 126;     // '~'
+    const int NUM_GLYPHS = LAST_GLYPH - FIRST_GLYPH + 1;
+
+    // printable ASCII rasterized once per font into one texture, tinted per draw with color mod
+    struct GlyphAtlas {
+        SDL_Texture* texture;
+        SDL_Rect glyphs[NUM_GLYPHS];    // source rect of each glyph in the atlas
+        int advance[NUM_GLYPHS];        // horizontal pen advance of each glyph
+        int height;                     // line height of the font
+    };
+
+    struct ResourceStats {
+        int fontsResident;
+        int fontLoads;          // fonts actually opened from disk
+        int fontHits;           // acquisitions served from the cache
+        double fontLoadMs;      // total time spent opening fonts and rasterizing glyphs
+        int texturesResident;
+        int textureLoads;
+        int textureHits;
+        double textureLoadMs;
+        size_t residentBytes;   // font files + atlas and generated texture pixels
+    };
+
+    // start opening a font and rasterizing its glyphs on a background thread
+    void PreloadFontAsync(const char* path, int size);
+    void WaitForPreload();
+
+    // lazily open (or share) a font; every acquire must be paired with a release
+    TTF_Font* AcquireFont(const char* path, int size);
+    void ReleaseFont(TTF_Font* font);
+
+    // glyph atlas of an acquired font, uploaded to the renderer on first use
+    const GlyphAtlas* GetGlyphAtlas(SDL_Renderer* renderer, TTF_Font* font);
+
+    // texture identified by key, produced once by generate() and shared until the last release
+    SDL_Texture* AcquireTexture(SDL_Renderer* renderer, const std::string& key, const std::function<SDL_Surface*()>& generate);
+    void ReleaseTexture(SDL_Renderer* renderer, const std::string& key);
+
+    ResourceStats GetResourceStats();
+    void PrintResourceStats();
+
+    // close everything still cached; call before TTF_Quit()
+    void ShutdownResources();
+}
+
+#endif
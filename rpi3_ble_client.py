@@ -15,7 +15,11 @@ CHARACTERISTIC_UUID_Y = "d43bfa36-280a-495c-9e10-99f5d1bdc43e"
 CHARACTERISTIC_UUID_BTN = "0bc7ad76-3ffd-4da4-8e3e-09613eddf3c4"
 
 # path of fifo to write to
-FIFO_PATH = "/tmp/joystick_fifo"
+# usage: rpi3_ble_client.py [FIFO_PATH [DEVICE_ADDRESS]]
+# run one bridge per controller, each on its own fifo, and pass every fifo to game_menu with --fifo
+FIFO_PATH = sys.argv[1] if len(sys.argv) > 1 else "/tmp/joystick_fifo"
+# with two controllers advertising the same name, pick one by address
+TARGET_ADDRESS = sys.argv[2] if len(sys.argv) > 2 else None
 
 # global dictionary to store the latest values
 # initialized with NEUTRAL/RELEASED defaults
@@ -35,6 +39,9 @@ def notification_handler(characteristic: BleakGATTCharacteristic, data: bytearra
     """Handles incoming BLE notifications, updates state, and writes to FIFO."""
     global fifo_out, fifo_ready, joystick_data, num_cmd_received
 
+    # wall-clock receive time, forwarded so the game can split latency into hops
+    receive_us = time.time_ns() // 1000
+
     # print time when command was received
     if num_cmd_received < MAX_CMD_TO_PRINT:
         print(time.time())
@@ -46,8 +53,10 @@ def notification_handler(characteristic: BleakGATTCharacteristic, data: bytearra
 
     data_changed = False
     try:
-        # convert received string to integer
-        value = int(decoded_data)
+        # "<value> <ESP32 send time in ms>"; older firmware sends only the value
+        fields = decoded_data.split()
+        value = int(fields[0])
+        send_ms = int(fields[1]) if len(fields) > 1 else -1
 
         # compare the characteristic's UUID with your defined constants
         if char_uuid == CHARACTERISTIC_UUID_X:
@@ -70,8 +79,11 @@ def notification_handler(characteristic: BleakGATTCharacteristic, data: bytearra
         # if data changed and fifo is ready, write the current state
         if data_changed and fifo_ready and fifo_out:
             try:
-                # format: X Y Button\n (using current state)
-                output_string = f"{joystick_data['X']} {joystick_data['Y']} {joystick_data['Button']}\n"
+                # format: X Y Button ESP32_send_ms bridge_receive_us\n (using current state)
+                output_string = (
+                    f"{joystick_data['X']} {joystick_data['Y']} {joystick_data['Button']} "
+                    f"{send_ms} {receive_us}\n"
+                )
                 fifo_out.write(output_string)
                 fifo_out.flush()
             except BrokenPipeError:
@@ -114,7 +126,7 @@ async def main():
     target_address = None
     devices = await BleakScanner.discover()
     for d in devices:
-        if d.name == TARGET_DEVICE_NAME:
+        if d.name == TARGET_DEVICE_NAME and (TARGET_ADDRESS is None or d.address.upper() == TARGET_ADDRESS.upper()):
             target_address = d.address
             print(f"Found target device: {d.name} ({target_address})")
             break
@@ -0,0 +1,29 @@
+#include "sim.h"
+#include "logger.h"
+#include "options.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+    float TickScale() {
+        return static_cast<float>(DESIGN_HZ) / options.simHz;
+    }
+
+    float TickSeconds() {
+        return 1.0f / options.simHz;
+    }
+
+    Uint64 TickUs() {
+        return (1000000 + options.simHz / 2) / options.simHz;
+    }
+
+    void LimitToDisplay(int refreshHz) {
+        if (refreshHz <= 0 || options.simHz <= refreshHz) return;
+        logger::Warn("--sim-hz %d is above the %d Hz display refresh, simulating at %d Hz", options.simHz, refreshHz, refreshHz);
+        options.simHz = refreshHz;
+    }
+
+    int ScaleTicks(int designTicks) {
+        return std::max(1, static_cast<int>(std::lround(static_cast<double>(designTicks) * options.simHz / DESIGN_HZ)));
+    }
+}
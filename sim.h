@@ -0,0 +1,26 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <SDL2/SDL.h>
+
+// fixed simulation rate (--sim-hz): the games advance one tick per loop and pace the loop
+// to the tick, so 30 Hz halves the CPU spent per second on constrained hardware; presents are
+// vsync'd, so the rate is capped at the display refresh
+// speeds and spawn intervals are tuned in 60 Hz ticks and scaled here, so a spear covers the
+// same distance per second at any rate; collision is swept (collision.h) so bigger steps
+// cannot skip past the player
+namespace sim {
+    const int DESIGN_HZ = 60;
+
+    // distance per tick multiplier, DESIGN_HZ / sim rate
+    float TickScale();
+    float TickSeconds();
+    // FrameDelayUs period, exact to the microsecond so odd rates do not drift
+    Uint64 TickUs();
+    // a vsync'd loop cannot tick faster than the display; clamps --sim-hz to its refresh
+    void LimitToDisplay(int refreshHz);
+    // a count of 60 Hz ticks at the current rate, at least 1
+    int ScaleTicks(int designTicks);
+}
+
+#endif
@@ -0,0 +1,209 @@
+#include "softraster.h"
+#include "logger.h"
+#include "menu.h"
+#include "telemetry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    // GCC/Clang vector extensions: SSE2 on x86, NEON on the Pi, no intrinsics needed
+    typedef uint32_t U32x4 __attribute__((vector_size(16)));
+    typedef int32_t I32x4 __attribute__((vector_size(16)));
+    const int LANES = 4;
+
+    SDL_Texture* texture = nullptr;
+    uint32_t* pixels = nullptr;     // the locked texture while a frame is active
+    int stride = 0;                 // in pixels
+    bool active = false;
+
+    uint32_t Pack(SDL_Color color) {
+        return 0xff000000u | color.r << 16 | color.g << 8 | color.b;   // ARGB8888
+    }
+
+    // the frame buffer pitch has no alignment guarantee, so every vector access is unaligned
+    inline U32x4 Load(const uint32_t* at) {
+        U32x4 value;
+        memcpy(&value, at, sizeof(value));
+        return value;
+    }
+
+    inline void Store(uint32_t* at, U32x4 value) {
+        memcpy(at, &value, sizeof(value));
+    }
+
+    // [x0, x1) of row y, already clipped
+    void FillSpan(int y, int x0, int x1, uint32_t color) {
+        uint32_t* row = pixels + y * stride;
+        U32x4 fill = {color, color, color, color};
+        int x = x0;
+        for (; x + LANES <= x1; x += LANES) Store(row + x, fill);
+        for (; x < x1; x++) row[x] = color;
+    }
+
+    void ClippedSpan(int y, int x0, int x1, uint32_t color) {
+        if (y < 0 || y >= SCREEN_HEIGHT) return;
+        x0 = std::max(x0, 0);
+        x1 = std::min(x1, SCREEN_WIDTH);
+        if (x0 < x1) FillSpan(y, x0, x1, color);
+    }
+
+    void Plot(int x, int y, uint32_t color) {
+        if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) pixels[y * stride + x] = color;
+    }
+
+    // largest h with h * h <= value
+    int IntSqrt(int value) {
+        int root = static_cast<int>(std::sqrt(static_cast<float>(value)));
+        while (root * root > value) root--;
+        while ((root + 1) * (root + 1) <= value) root++;
+        return root;
+    }
+}
+
+namespace softraster {
+    bool InitSoftRaster(SDL_Renderer* renderer) {
+        texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, SCREEN_WIDTH, SCREEN_HEIGHT);
+        if (!texture) {
+            logger::Warn("No streaming texture for the software rasterizer (%s), using SDL primitives", SDL_GetError());
+            return false;
+        }
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+        logger::Info("World rendered by the software rasterizer");
+        return true;
+    }
+
+    void ShutdownSoftRaster() {
+        if (texture) SDL_DestroyTexture(texture);
+        texture = nullptr;
+    }
+
+    bool Enabled() {
+        return texture != nullptr;
+    }
+
+    bool BeginFrame(SDL_Renderer* renderer) {
+        if (!texture) return false;
+        void* locked;
+        int pitch;
+        if (SDL_LockTexture(texture, nullptr, &locked, &pitch) != 0) return false;
+        pixels = static_cast<uint32_t*>(locked);
+        stride = pitch / 4;
+        active = true;
+        // locked contents are undefined, every frame starts from black
+        SDL_Color black = {0, 0, 0, 255};
+        SDL_Rect all = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+        FillRect(all, black);
+        return true;
+    }
+
+    void EndFrame(SDL_Renderer* renderer) {
+        if (!active) return;
+        active = false;
+        SDL_UnlockTexture(texture);
+        pixels = nullptr;
+        SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+        telemetry::CountDrawCalls(1);
+    }
+
+    bool Active() {
+        return active;
+    }
+
+    void FillRect(const SDL_Rect& rect, SDL_Color color) {
+        int y0 = std::max(rect.y, 0), y1 = std::min(rect.y + rect.h, SCREEN_HEIGHT);
+        int x0 = std::max(rect.x, 0), x1 = std::min(rect.x + rect.w, SCREEN_WIDTH);
+        if (x0 >= x1) return;
+        uint32_t packed = Pack(color);
+        for (int y = y0; y < y1; y++) FillSpan(y, x0, x1, packed);
+    }
+
+    // same pixels as the point-by-point FillCircle: offsets in (-r, r] with dx^2 + dy^2 <= r^2
+    void FillCircle(int centreX, int centreY, int radius, SDL_Color color) {
+        uint32_t packed = Pack(color);
+        int squared = radius * radius;
+        for (int dy = -radius + 1; dy <= radius; dy++) {
+            int half = IntSqrt(squared - dy * dy);
+            int left = std::max(-half, -radius + 1), right = std::min(half, radius);
+            ClippedSpan(centreY + dy, centreX + left, centreX + right + 1, packed);
+        }
+    }
+
+    // the midpoint outline DrawCircle plots with SDL points
+    void DrawCircle(int centreX, int centreY, int radius, SDL_Color color) {
+        uint32_t packed = Pack(color);
+        const int diameter = radius * 2;
+        int x = radius - 1, y = 0, tx = 1, ty = 1;
+        int error = tx - diameter;
+        while (x >= y) {
+            Plot(centreX + x, centreY - y, packed); Plot(centreX + x, centreY + y, packed);
+            Plot(centreX - x, centreY - y, packed); Plot(centreX - x, centreY + y, packed);
+            Plot(centreX + y, centreY - x, packed); Plot(centreX + y, centreY + x, packed);
+            Plot(centreX - y, centreY - x, packed); Plot(centreX - y, centreY + x, packed);
+            if (error <= 0) { ++y; error += ty; ty += 2; }
+            if (error > 0) { --x; tx += 2; error += tx - diameter; }
+        }
+    }
+
+    // edge functions in doubled coordinates, so pixel centres (x + 0.5) are integers;
+    // four pixels per step, each lane kept if it is inside all three edges
+    void FillTriangle(const SDL_FPoint points[3], SDL_Color color) {
+        int vx[3], vy[3];
+        for (int i = 0; i < 3; i++) {
+            vx[i] = static_cast<int>(lroundf(points[i].x * 2));
+            vy[i] = static_cast<int>(lroundf(points[i].y * 2));
+        }
+        int area = (vx[1] - vx[0]) * (vy[2] - vy[0]) - (vy[1] - vy[0]) * (vx[2] - vx[0]);
+        if (area == 0) return;
+        if (area < 0) {
+            std::swap(vx[1], vx[2]);
+            std::swap(vy[1], vy[2]);
+        }
+
+        int minX = std::max(*std::min_element(vx, vx + 3) / 2, 0);
+        int maxX = std::min(*std::max_element(vx, vx + 3) / 2, SCREEN_WIDTH - 1);
+        int minY = std::max(*std::min_element(vy, vy + 3) / 2, 0);
+        int maxY = std::min(*std::max_element(vy, vy + 3) / 2, SCREEN_HEIGHT - 1);
+        if (minX > maxX || minY > maxY) return;
+
+        // E(p) = a * p.x + b * p.y + c for the edge from vertex i to vertex i + 1
+        int a[3], b[3], c[3];
+        for (int i = 0; i < 3; i++) {
+            int j = (i + 1) % 3;
+            a[i] = -(vy[j] - vy[i]);
+            b[i] = vx[j] - vx[i];
+            c[i] = -(a[i] * vx[i] + b[i] * vy[i]);
+        }
+
+        uint32_t packed = Pack(color);
+        U32x4 fill = {packed, packed, packed, packed};
+        const I32x4 lane = {0, 1, 2, 3};
+        int px0 = minX * 2 + 1;
+        for (int y = minY; y <= maxY; y++) {
+            int py = y * 2 + 1;
+            I32x4 edge[3], step[3];
+            int rowStart[3];
+            for (int i = 0; i < 3; i++) {
+                rowStart[i] = a[i] * px0 + b[i] * py + c[i];
+                edge[i] = rowStart[i] + lane * (a[i] * 2);
+                step[i] = I32x4{0, 0, 0, 0} + a[i] * 2 * LANES;
+            }
+
+            uint32_t* row = pixels + y * stride;
+            int x = minX;
+            for (; x + LANES <= maxX + 1; x += LANES) {
+                // a lane is inside when no edge value has its sign bit set
+                I32x4 inside = (edge[0] | edge[1] | edge[2]) >= 0;
+                if (inside[0] | inside[1] | inside[2] | inside[3]) {
+                    U32x4 mask = (U32x4)inside;
+                    Store(row + x, (Load(row + x) & ~mask) | (fill & mask));
+                }
+                for (int i = 0; i < 3; i++) edge[i] += step[i];
+            }
+            for (; x <= maxX; x++) {
+                int offset = (x - minX) * 2;
+                if (((rowStart[0] + a[0] * offset) | (rowStart[1] + a[1] * offset) | (rowStart[2] + a[2] * offset)) >= 0) row[x] = packed;
+            }
+        }
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef SOFTRASTER_H
+#define SOFTRASTER_H
+
+#include <SDL2/SDL.h>
+
+// software rasterizer backend for the game world (--renderer sw), for Pi images whose
+// "accelerated" driver is slower than the CPU: players and spears are rasterized with
+// 4-wide vector spans straight into a locked streaming texture, uploaded once per frame
+// the HUD and menus still go through the SDL renderer
+namespace softraster {
+    // creates the streaming texture; false leaves the world on SDL primitives
+    bool InitSoftRaster(SDL_Renderer* renderer);
+    void ShutdownSoftRaster();
+    bool Enabled();
+
+    // wrap the world drawing; while active the asset helpers below replace the SDL primitives
+    bool BeginFrame(SDL_Renderer* renderer);
+    void EndFrame(SDL_Renderer* renderer);
+    bool Active();
+
+    // game coordinates, clipped to the arena; colours are opaque
+    void FillRect(const SDL_Rect& rect, SDL_Color color);
+    void FillCircle(int centreX, int centreY, int radius, SDL_Color color);
+    void DrawCircle(int centreX, int centreY, int radius, SDL_Color color);
+    void FillTriangle(const SDL_FPoint points[3], SDL_Color color);
+}
+
+#endif
@@ -1,20 +1,73 @@
 #include "spear_blocker.h"
+#include "alloc_tracker.h"
+#include "capture.h"
+#include "collision.h"
+#include "input.h"
+#include "journal.h"
+#include "logger.h"
+#include "options.h"
+#include "particles.h"
+#include "render_scale.h"
+#include "resources.h"
+#include "sim.h"
+#include "telemetry.h"
+#include <algorithm>
 
 int SPEAR_COUNTER = 0;                          // counter for spears
+static int best_score = -1;                     // shown on the game over screen
 const int BLOCK_ZONE_SIZE = PLAYER_SIZE + 20;   // keep block zone relative
 using namespace spear_blocker;
 
+// the point of a spear that has to reach the block zone
+static SDL_Point SpearTip(const SDL_Rect& rect, Direction direction) {
+    switch (direction) {
+        case Direction::UP:    return {rect.x + rect.w / 2, rect.y + rect.h};
+        case Direction::DOWN:  return {rect.x + rect.w / 2, rect.y};
+        case Direction::LEFT:  return {rect.x + rect.w, rect.y + rect.h / 2};
+        case Direction::RIGHT: return {rect.x, rect.y + rect.h / 2};
+        case Direction::NONE:  break;
+    }
+    return {rect.x, rect.y};
+}
+
+// move a spear one tick and sweep its tip through the zone; a spear that reaches the zone is
+// pulled back to where it touched, so it never shows past the shield
+static bool MoveSpear(Spear& spear, const SDL_Rect& blockZone, float& toi) {
+    float step = spear.speed * sim::TickScale();
+    float dx = 0, dy = 0;
+    switch (spear.originDirection) {
+        case Direction::UP:    dy = step; break;
+        case Direction::DOWN:  dy = -step; break;
+        case Direction::LEFT:  dx = step; break;
+        case Direction::RIGHT: dx = -step; break;
+        case Direction::NONE:  return false;
+    }
+    spear.previous = spear.rect;
+    spear.x += dx;
+    spear.y += dy;
+    spear.rect.x = static_cast<int>(spear.x);
+    spear.rect.y = static_cast<int>(spear.y);
+
+    SDL_Point from = SpearTip(spear.previous, spear.originDirection);
+    SDL_Point to = SpearTip(spear.rect, spear.originDirection);
+    if (!collision::SweepPoint(from.x, from.y, to.x, to.y, blockZone, toi)) return false;
+    spear.x -= dx * (1 - toi);
+    spear.y -= dy * (1 - toi);
+    spear.rect.x = static_cast<int>(spear.x);
+    spear.rect.y = static_cast<int>(spear.y);
+    return true;
+}
+
 int SpearBlockerMain(SDL_Window* window, SDL_Renderer* renderer) {
-    TTF_Font* font = nullptr;
-    font = TTF_OpenFont(FONT_PATH, 28);
+    // shared with the menu, so entering a game does not reopen the font
+    TTF_Font* font = resources::AcquireFont(FONT_PATH, 28);
     if (!font) {
-        printf("Failed to load font! TTF_Error: %s\n", TTF_GetError());
-        printf("Ensure the path '%s' is correct.\n", FONT_PATH);
-        SDL_DestroyRenderer(renderer); SDL_DestroyWindow(window); TTF_Quit(); SDL_Quit();
-        return false;
+        logger::Error("Failed to load font! TTF_Error: %s", TTF_GetError());
+        logger::Error("Ensure the path '%s' is correct.", FONT_PATH);
+        return -1;  // main cleans up the window and renderer
     }
 
-    srand(time(0));
+    srand(options.seed ? options.seed : time(0));
 
     // game variables
     bool running = true;
@@ -44,10 +97,12 @@ int SpearBlockerMain(SDL_Window* window, SDL_Renderer* renderer) {
     blockZone.y = static_cast<int>(player.y - BLOCK_ZONE_SIZE / 2.0f);
 
     std::vector<Spear> spears;
+    spears.reserve(MAX_SPEARS);
 
     // game loop
     while (running) {
         printFPS();
+        input::PumpInput();
 
         startGame = false;
         HandleInput(running, player, gameState, menuSelectedOption, difficulty, startGame);
@@ -62,10 +117,12 @@ int SpearBlockerMain(SDL_Window* window, SDL_Renderer* renderer) {
                     {
                         startGame = false;
                         RETURN_TO_MENU = 0;
+                        resources::ReleaseFont(font);
                         return 0;
                     }
                     SPEAR_COUNTER = 0;
                     ResetGame(player, spears, gameState, currentSettings);
+                    journal::BeginSession(journal::Game::BLOCKER, static_cast<int>(difficulty));
                     gameOverFlag = false;
                     frameCount = 0;
                     blockZone.x = static_cast<int>(player.x - BLOCK_ZONE_SIZE / 2.0f);
@@ -77,14 +134,16 @@ int SpearBlockerMain(SDL_Window* window, SDL_Renderer* renderer) {
                     UpdateGame(player, spears, gameOverFlag, blockZone, currentSettings);
 
                     frameCount++;
-                    if (frameCount >= currentSettings.spawnRate/ currentSettings.spearMult) {
-                        SpawnSpear(spears, currentSettings);
+                    if (frameCount >= sim::ScaleTicks(currentSettings.spawnRate / currentSettings.spearMult)) {
+                        if (spears.size() < MAX_SPEARS) SpawnSpear(spears, currentSettings);
                         frameCount = 0;
                     }
 
                     if (gameOverFlag) {
                         gameState = GameState::GAME_OVER;
-                        printf("Game Over!\n");
+                        logger::Info("Game Over!");
+                        journal::EndSession(SPEAR_COUNTER, -1);
+                        best_score = journal::BestScore(journal::Game::BLOCKER, static_cast<int>(difficulty));
                     }
                 }
                 break;
@@ -92,11 +151,103 @@ int SpearBlockerMain(SDL_Window* window, SDL_Renderer* renderer) {
                 break;
         }
 
+        particles::UpdateParticles(sim::TickSeconds());
+        telemetry::SetSpearCount(spears.size());
+        alloc_tracker::SetFrameSteady(gameState == GameState::PLAYING);
         RenderGame(renderer, font, player, spears, gameState, menuSelectedOption, gameOverFlag);
-        SDL_Delay(16);
+        FrameDelayUs(sim::TickUs());
     }
 
-    return 0;
+    resources::ReleaseFont(font);
+    return running ? 0 : -1;    // -1 asks main to quit
+}
+
+int SpearBlockerVersusMain(SDL_Window* window, SDL_Renderer* renderer) {
+    TTF_Font* font = resources::AcquireFont(FONT_PATH, 28);
+    if (!font) {
+        logger::Error("Failed to load font! TTF_Error: %s", TTF_GetError());
+        logger::Error("Ensure the path '%s' is correct.", FONT_PATH);
+        return -1;  // main cleans up the window and renderer
+    }
+
+    srand(options.seed ? options.seed : time(0));
+
+    // game variables
+    GameState gameState = GameState::MENU;
+    Difficulty difficulty = Difficulty::MEDIUM;
+    Settings currentSettings = GetSettingsForDifficulty(difficulty);
+    int frameCount = 0;
+    int menuSelectedOption = 0;
+    bool startGame = false;
+    int loser = -1;
+    int blocked[VERSUS_PLAYERS] = {};
+
+    Player players[VERSUS_PLAYERS];
+    SDL_Rect zones[VERSUS_PLAYERS];
+    std::vector<Spear> spears;
+    spears.reserve(MAX_SPEARS);
+    ResetVersus(players, zones, spears, blocked, gameState);
+    gameState = GameState::MENU;
+
+    // game loop
+    while (true) {
+        printFPS();
+        input::PumpInput();
+
+        startGame = false;
+        if (HandleVersusInput(players, gameState, menuSelectedOption, difficulty, startGame) == -1) {
+            resources::ReleaseFont(font);
+            return -1;
+        }
+
+        switch (gameState) {
+            case GameState::MENU:
+                if (startGame) {
+                    if (RETURN_TO_MENU == 1) {
+                        RETURN_TO_MENU = 0;
+                        resources::ReleaseFont(font);
+                        return 0;
+                    }
+                    currentSettings = GetSettingsForDifficulty(difficulty);
+                    ResetVersus(players, zones, spears, blocked, gameState);
+                    journal::BeginSession(journal::Game::BLOCKER_VERSUS, static_cast<int>(difficulty));
+                    loser = -1;
+                    frameCount = 0;
+                }
+                break;
+            case GameState::PLAYING:
+                UpdateVersus(players, spears, loser, zones, blocked);
+
+                frameCount++;
+                if (frameCount >= sim::ScaleTicks(currentSettings.spawnRate / currentSettings.spearMult)) {
+                    // one spear at each player, so neither side gets an easier stream
+                    for (const Player& player : players) {
+                        if (spears.size() < MAX_SPEARS) SpawnVersusSpear(spears, currentSettings, player);
+                    }
+                    frameCount = 0;
+                }
+
+                if (loser == VERSUS_PLAYERS) {
+                    gameState = GameState::GAME_OVER;
+                    logger::Info("Draw!");
+                    journal::EndSession(std::max(blocked[0], blocked[1]), -1);
+                }
+                else if (loser >= 0) {
+                    gameState = GameState::GAME_OVER;
+                    logger::Info("Player %d wins!", VERSUS_PLAYERS - loser);
+                    journal::EndSession(blocked[VERSUS_PLAYERS - 1 - loser], VERSUS_PLAYERS - 1 - loser);
+                }
+                break;
+            case GameState::GAME_OVER:
+                break;
+        }
+
+        particles::UpdateParticles(sim::TickSeconds());
+        telemetry::SetSpearCount(spears.size());
+        alloc_tracker::SetFrameSteady(gameState == GameState::PLAYING);
+        RenderVersus(renderer, font, players, spears, gameState, menuSelectedOption, blocked, loser);
+        FrameDelayUs(sim::TickUs());
+    }
 }
 
 namespace spear_blocker {
@@ -121,10 +272,15 @@ namespace spear_blocker {
     }
 
     int HandleInput(bool& running, Player& player, GameState& gameState, int& selectedOption, Difficulty& difficulty, bool& startGame){
-        if (gameState == GameState::MENU) {
-            std::lock_guard<std::mutex> lock(joy_mutex);
-            if (joy_action) {
-                joy_action = false;
+        if (input::QuitRequested()) {
+            running = false;
+            return -1;
+        }
+
+        input::InputEvent event;
+        while (input::PollInputEvent(event)) {
+            const Joystick& joy = event.state;
+            if (gameState == GameState::MENU) {
                 if (joy.y == UP) selectedOption = (selectedOption-1+4)%4;
                 if (joy.y == DOWN) selectedOption = (selectedOption+1)%4;
                 if (joy.btn == PRESSED) {
@@ -133,26 +289,20 @@ namespace spear_blocker {
                     else if (selectedOption==2) difficulty = Difficulty::HARD;
                     else RETURN_TO_MENU = true;
                     startGame = true;
+                    return 0;   // leave the rest of the queue for the next state
                 }
             }
-        }
-        else if (gameState == GameState::PLAYING) {
-            std::lock_guard<std::mutex> lock(joy_mutex);
-            if (joy_action) {
-                joy_action = false;
+            else if (gameState == GameState::PLAYING) {
                 if (joy.y == UP) player.facing = Direction::UP;
                 if (joy.y == DOWN) player.facing = Direction::DOWN;
                 if (joy.x == LEFT) player.facing = Direction::LEFT;
                 if (joy.x == RIGHT) player.facing = Direction::RIGHT;
             }
-        }
-        else if (gameState == GameState::GAME_OVER) {
-            std::lock_guard<std::mutex> lock(joy_mutex);
-            if (joy_action) {
-                joy_action = false;
+            else if (gameState == GameState::GAME_OVER) {
                 if (joy.btn==PRESSED) {
                     gameState = GameState::MENU;
                     selectedOption = 0;
+                    return 0;
                 }
             }
         }
@@ -160,27 +310,20 @@ namespace spear_blocker {
     }
 
     void UpdateGame(Player& player, std::vector<Spear>& spears, bool& gameOver, const SDL_Rect& blockZone, const Settings& settings) {
+        // move every spear first: only blocks that land no later than the first hit in the tick count
+        float impact[MAX_SPEARS];
+        float firstHit = 2;   // past the end of the tick
+        for (size_t i = 0; i < spears.size(); i++) {
+            if (!MoveSpear(spears[i], blockZone, impact[i])) impact[i] = 2;
+            else if (player.facing != spears[i].originDirection) firstHit = std::min(firstHit, impact[i]);
+        }
+
         for (int i = spears.size() - 1; i >= 0; --i) {
-            // move spear
-            switch (spears[i].originDirection) {
-                case Direction::UP:    spears[i].y += spears[i].speed; break;
-                case Direction::DOWN:  spears[i].y -= spears[i].speed; break;
-                case Direction::LEFT:  spears[i].x += spears[i].speed; break;
-                case Direction::RIGHT: spears[i].x -= spears[i].speed; break;
-                case Direction::NONE:  break;
-            }
-            spears[i].rect.x = static_cast<int>(spears[i].x);
-            spears[i].rect.y = static_cast<int>(spears[i].y);
-
-            // check collision/block
-            if (CheckSpearInBlockZone(spears[i], blockZone)) {
-                if (player.facing == spears[i].originDirection) {
-                    spears.erase(spears.begin() + i);   // blocked
-                    SPEAR_COUNTER++;
-                } else {
-                    gameOver = true;                    // hit
-                    return;
-                }
+            if (impact[i] <= 1) {
+                if (player.facing != spears[i].originDirection || impact[i] > firstHit) continue;
+                particles::EmitBlock(spears[i].x + spears[i].rect.w / 2.0f, spears[i].y + spears[i].rect.h / 2.0f);
+                spears.erase(spears.begin() + i);   // blocked
+                SPEAR_COUNTER++;
             }
             // remove off-screen spears
             else if (spears[i].y < -SPEAR_LENGTH * 2 || spears[i].y > SCREEN_HEIGHT + SPEAR_LENGTH ||
@@ -188,19 +331,18 @@ namespace spear_blocker {
                 spears.erase(spears.begin() + i);
             }
         }
+
+        if (firstHit <= 1) {
+            particles::EmitHit(player.x, player.y);
+            gameOver = true;                            // hit
+        }
     }
 
     bool CheckSpearInBlockZone(const Spear& spear, const SDL_Rect& blockZone) {
-        int tipX = spear.rect.x, tipY = spear.rect.y;
-        switch (spear.originDirection) {
-            case Direction::UP:    tipX = spear.rect.x + spear.rect.w / 2; tipY = spear.rect.y + spear.rect.h; break;
-            case Direction::DOWN:  tipX = spear.rect.x + spear.rect.w / 2; tipY = spear.rect.y; break;
-            case Direction::LEFT:  tipX = spear.rect.x + spear.rect.w; tipY = spear.rect.y + spear.rect.h / 2; break;
-            case Direction::RIGHT: tipX = spear.rect.x; tipY = spear.rect.y + spear.rect.h / 2; break;
-            case Direction::NONE: return false;
-        }
-        return (tipX >= blockZone.x && tipX < blockZone.x + blockZone.w &&
-                tipY >= blockZone.y && tipY < blockZone.y + blockZone.h);
+        if (spear.originDirection == Direction::NONE) return false;
+        SDL_Point tip = SpearTip(spear.rect, spear.originDirection);
+        return (tip.x >= blockZone.x && tip.x < blockZone.x + blockZone.w &&
+                tip.y >= blockZone.y && tip.y < blockZone.y + blockZone.h);
     }
 
     void SpawnSpear(std::vector<Spear>& spears, const Settings& settings) {
@@ -225,6 +367,7 @@ namespace spear_blocker {
         }
         newSpear.x = spawnX; newSpear.y = spawnY;
         newSpear.rect.x = static_cast<int>(newSpear.x); newSpear.rect.y = static_cast<int>(newSpear.y);
+        newSpear.previous = newSpear.rect;
         spears.push_back(newSpear);
     }
 
@@ -237,17 +380,175 @@ namespace spear_blocker {
         } 
         else if (gameState == GameState::PLAYING || gameState == GameState::GAME_OVER) {
             if (renderer) {
+                render_scale::BeginWorld(renderer);
                 RenderPlayerCharacter(renderer, player, gameOverFlag, 1);
                 SDL_SetRenderDrawColor(renderer, 0, 180, 255, 255);
                 for (const auto& spear : spears) {
                     RenderSpear(renderer, spear);
                 }
+                render_scale::EndWorld(renderer);
+                particles::RenderParticles(renderer);
                 RenderScore(renderer, font, SPEAR_COUNTER);  // only one simple call now
             }
             if (gameState == GameState::GAME_OVER) {
-                if (font) RenderGameOver(renderer, font, SPEAR_COUNTER);
+                if (font) RenderGameOver(renderer, font, SPEAR_COUNTER, best_score);
             }
         }
-        SDL_RenderPresent(renderer);
+        capture::PresentFrame(renderer);
     }
-}
\ No newline at end of file
+
+    int HandleVersusInput(Player players[], GameState& gameState, int& selectedOption, Difficulty& difficulty, bool& startGame) {
+        if (input::QuitRequested()) return -1;
+
+        input::InputEvent event;
+        if (gameState == GameState::PLAYING) {
+            // each blocker only follows its own controller
+            for (int i = 0; i < VERSUS_PLAYERS; i++) {
+                while (input::PollPlayerEvent(i, event)) {
+                    const Joystick& joy = event.state;
+                    if (joy.y == UP) players[i].facing = Direction::UP;
+                    if (joy.y == DOWN) players[i].facing = Direction::DOWN;
+                    if (joy.x == LEFT) players[i].facing = Direction::LEFT;
+                    if (joy.x == RIGHT) players[i].facing = Direction::RIGHT;
+                }
+            }
+            return 0;
+        }
+
+        // menus follow whichever player pressed first
+        while (input::PollInputEvent(event)) {
+            const Joystick& joy = event.state;
+            if (gameState == GameState::MENU) {
+                if (joy.y == UP) selectedOption = (selectedOption-1+4)%4;
+                if (joy.y == DOWN) selectedOption = (selectedOption+1)%4;
+                if (joy.btn == PRESSED) {
+                    if (selectedOption == 0) difficulty = Difficulty::EASY;
+                    else if (selectedOption == 1) difficulty = Difficulty::MEDIUM;
+                    else if (selectedOption==2) difficulty = Difficulty::HARD;
+                    else RETURN_TO_MENU = true;
+                    startGame = true;
+                    return 0;   // leave the rest of the queue for the next state
+                }
+            }
+            else if (gameState == GameState::GAME_OVER) {
+                if (joy.btn==PRESSED) {
+                    gameState = GameState::MENU;
+                    selectedOption = 0;
+                    return 0;
+                }
+            }
+        }
+        return 0;
+    }
+
+    void ResetVersus(Player players[], SDL_Rect zones[], std::vector<Spear>& spears, int blocked[], GameState& gameState) {
+        for (int i = 0; i < VERSUS_PLAYERS; i++) {
+            // player 1 in the left half, player 2 in the right
+            Player& player = players[i];
+            player.index = i;
+            player.x = static_cast<float>(SCREEN_WIDTH * (2 * i + 1) / (2 * VERSUS_PLAYERS));
+            player.y = static_cast<float>(SCREEN_HEIGHT / 2);
+            player.rect.w = PLAYER_SIZE;
+            player.rect.h = PLAYER_SIZE;
+            player.rect.x = static_cast<int>(player.x - player.rect.w / 2.0f);
+            player.rect.y = static_cast<int>(player.y - player.rect.h / 2.0f);
+            player.facing = Direction::UP;
+
+            zones[i].w = BLOCK_ZONE_SIZE;
+            zones[i].h = BLOCK_ZONE_SIZE;
+            zones[i].x = static_cast<int>(player.x - BLOCK_ZONE_SIZE / 2.0f);
+            zones[i].y = static_cast<int>(player.y - BLOCK_ZONE_SIZE / 2.0f);
+            blocked[i] = 0;
+        }
+        spears.clear();
+        gameState = GameState::PLAYING;
+    }
+
+    void SpawnVersusSpear(std::vector<Spear>& spears, const Settings& settings, const Player& target) {
+        Spear newSpear;
+        newSpear.speed = settings.spearSpeed;
+        newSpear.target = target.index;
+        // top, bottom or the player's outer edge; a spear from the inner edge would cross the other zone
+        int side = rand() % 3;
+        if (side == 2 && target.index == VERSUS_PLAYERS - 1) side = 3;
+        int width, height;
+
+        if (side == 0 || side == 1) { width = SPEAR_BASE_WIDTH; height = SPEAR_LENGTH; }
+        else { width = SPEAR_LENGTH; height = SPEAR_BASE_WIDTH; }
+        newSpear.rect.w = width; newSpear.rect.h = height;
+
+        float spawnX = 0, spawnY = 0;
+        switch (side) {
+            case 0: newSpear.originDirection = Direction::UP;    spawnX = target.x - width / 2.0f; spawnY = static_cast<float>(-height); break;
+            case 1: newSpear.originDirection = Direction::DOWN;  spawnX = target.x - width / 2.0f; spawnY = static_cast<float>(SCREEN_HEIGHT); break;
+            case 2: newSpear.originDirection = Direction::LEFT;  spawnX = static_cast<float>(-width); spawnY = target.y - height / 2.0f; break;
+            case 3: newSpear.originDirection = Direction::RIGHT; spawnX = static_cast<float>(SCREEN_WIDTH); spawnY = target.y - height / 2.0f; break;
+        }
+        newSpear.x = spawnX; newSpear.y = spawnY;
+        newSpear.rect.x = static_cast<int>(newSpear.x); newSpear.rect.y = static_cast<int>(newSpear.y);
+        newSpear.previous = newSpear.rect;
+        spears.push_back(newSpear);
+    }
+
+    void UpdateVersus(Player players[], std::vector<Spear>& spears, int& loser, const SDL_Rect zones[], int blocked[]) {
+        // both blockers hit in the same tick: the earlier impact loses, the same instant is a draw
+        float firstHit[VERSUS_PLAYERS];
+        for (float& toi : firstHit) toi = 2;   // past the end of the tick
+        for (int i = spears.size() - 1; i >= 0; --i) {
+            Spear& spear = spears[i];
+            float toi;
+            // only the targeted player can block or be hit
+            if (MoveSpear(spear, zones[spear.target], toi)) {
+                if (players[spear.target].facing == spear.originDirection) {
+                    blocked[spear.target]++;
+                    particles::EmitBlock(spear.x + spear.rect.w / 2.0f, spear.y + spear.rect.h / 2.0f);
+                    spears.erase(spears.begin() + i);
+                } else {
+                    firstHit[spear.target] = std::min(firstHit[spear.target], toi);
+                }
+            }
+            // remove off-screen spears
+            else if (spear.y < -SPEAR_LENGTH * 2 || spear.y > SCREEN_HEIGHT + SPEAR_LENGTH ||
+                    spear.x < -SPEAR_LENGTH * 2 || spear.x > SCREEN_WIDTH + SPEAR_LENGTH) {
+                spears.erase(spears.begin() + i);
+            }
+        }
+        float earliest = *std::min_element(firstHit, firstHit + VERSUS_PLAYERS);
+        if (earliest > 1) return;
+
+        int hits = 0;
+        for (int i = 0; i < VERSUS_PLAYERS; i++) {
+            if (firstHit[i] != earliest) continue;
+            loser = i;
+            hits++;
+            particles::EmitHit(players[i].x, players[i].y);
+        }
+        if (hits > 1) loser = VERSUS_PLAYERS;
+    }
+
+    void RenderVersus(SDL_Renderer* renderer, TTF_Font* font, const Player players[], const std::vector<Spear>& spears, GameState gameState, int selectedOption, const int blocked[], int loser) {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+
+        if (gameState == GameState::MENU) {
+            RenderMenu(renderer, font, selectedOption);
+        }
+        else {
+            render_scale::BeginWorld(renderer);
+            for (int i = 0; i < VERSUS_PLAYERS; i++) {
+                RenderPlayerCharacter(renderer, players[i], loser == i || loser == VERSUS_PLAYERS, 1);
+            }
+            SDL_SetRenderDrawColor(renderer, 0, 180, 255, 255);
+            for (const auto& spear : spears) {
+                RenderSpear(renderer, spear);
+            }
+            render_scale::EndWorld(renderer);
+            particles::RenderParticles(renderer);
+            RenderVersusScores(renderer, font, blocked[0], blocked[1]);
+            if (gameState == GameState::GAME_OVER) {
+                RenderVersusGameOver(renderer, font, loser >= 0 && loser < VERSUS_PLAYERS ? VERSUS_PLAYERS - 1 - loser : -1);
+            }
+        }
+        capture::PresentFrame(renderer);
+    }
+}
@@ -11,6 +11,9 @@
 #include <cmath>            // for M_PI, sin, cos
 
 int SpearBlockerMain(SDL_Window* window, SDL_Renderer* renderer);
+// two blockers side by side, each with its own zone and controller; the first one hit loses,
+// both hit at the same instant is a draw
+int SpearBlockerVersusMain(SDL_Window* window, SDL_Renderer* renderer);
 
 namespace spear_blocker {
     inline int RETURN_TO_MENU; // flag to return to menu
@@ -37,6 +40,13 @@ namespace spear_blocker {
     void RenderGame(SDL_Renderer* renderer, TTF_Font* font, const Player& player, const std::vector<Spear>& spears, GameState gameState, int selectedOption, bool gameOverFlag);
     bool CheckSpearInBlockZone(const Spear& spear, const SDL_Rect& blockZone);
     Settings GetSettingsForDifficulty(Difficulty difficulty);
+
+    // versus mode
+    int HandleVersusInput(Player players[], GameState& gameState, int& selectedOption, Difficulty& difficulty, bool& startGame);
+    void ResetVersus(Player players[], SDL_Rect zones[], std::vector<Spear>& spears, int blocked[], GameState& gameState);
+    void SpawnVersusSpear(std::vector<Spear>& spears, const Settings& settings, const Player& target);
+    void UpdateVersus(Player players[], std::vector<Spear>& spears, int& loser, const SDL_Rect zones[], int blocked[]);
+    void RenderVersus(SDL_Renderer* renderer, TTF_Font* font, const Player players[], const std::vector<Spear>& spears, GameState gameState, int selectedOption, const int blocked[], int loser);
 }
 
 #endif
@@ -1,29 +1,43 @@
 #include "spear_runner.h"
+#include "alloc_tracker.h"
+#include "capture.h"
+#include "collision.h"
 #include "assets.h"
+#include "input.h"
+#include "journal.h"
+#include "logger.h"
+#include "options.h"
+#include "particles.h"
+#include "render_scale.h"
+#include "resources.h"
+#include "sim.h"
+#include "telemetry.h"
+#include <algorithm>
 #include <cstdlib>
 #include <ctime>
 
 using namespace spear_runner;
 int SCORE_TIMER = 0;
+static int best_score = -1;     // shown on the game over screen
 Uint32 lastIncrementTime = SDL_GetTicks();  // current time in milliseconds
 
 int SpearRunnerMain(SDL_Window* window, SDL_Renderer* renderer) {
-    TTF_Font* font = nullptr;
-    font = TTF_OpenFont(FONT_PATH, 28);
+    // shared with the menu, so entering a game does not reopen the font
+    TTF_Font* font = resources::AcquireFont(FONT_PATH, 28);
     if (!font) {
-        printf("Failed to load font! TTF_Error: %s\n", TTF_GetError());
-        printf("Ensure the path '%s' is correct.\n", FONT_PATH);
-        SDL_DestroyRenderer(renderer); SDL_DestroyWindow(window); TTF_Quit(); SDL_Quit();
-        return false;
+        logger::Error("Failed to load font! TTF_Error: %s", TTF_GetError());
+        logger::Error("Ensure the path '%s' is correct.", FONT_PATH);
+        return -1;  // main cleans up the window and renderer
     }
 
-    srand(time(0));
+    srand(options.seed ? options.seed : time(0));
 
     GameState gameState = GameState::MENU;
     int selectedOption = 1; // 0=Easy, 1=Medium, 2=Hard, 3=Back
     bool gameOver = false;
     int frameCount = 0;
     Settings settings = GetSettingsForDifficulty(Difficulty::MEDIUM);
+    int difficulty = 0;     // of the session being played, selectedOption moves on in the menu
 
     Player player;
     player.x = SCREEN_WIDTH / 2.0f;
@@ -35,23 +49,33 @@ int SpearRunnerMain(SDL_Window* window, SDL_Renderer* renderer) {
     player.facing = Direction::UP;
 
     std::vector<Spear> spears;
+    spears.reserve(MAX_SPEARS);
 
     while (true) {
         printFPS();
+        input::PumpInput();
 
         float moveX = 0, moveY = 0;
+        GameState previous = gameState;
 
         if (HandleInput(player, gameState, selectedOption, gameOver, moveX, moveY, settings, frameCount, spears) == -1) {
+            resources::ReleaseFont(font);
             return -1;
         }
 
         if (gameState == GameState::MENU) {
             if (RETURN_TO_MENU) {
                 RETURN_TO_MENU = 0;
+                resources::ReleaseFont(font);
                 return 0; // exit the game loop
             }
         }
 
+        if (gameState == GameState::PLAYING && previous != GameState::PLAYING) {
+            difficulty = selectedOption;
+            journal::BeginSession(journal::Game::RUNNER, difficulty);
+        }
+
         // gameplay logic
         if (gameState == GameState::PLAYING && !gameOver) {
             // update score
@@ -61,12 +85,93 @@ int SpearRunnerMain(SDL_Window* window, SDL_Renderer* renderer) {
                 lastIncrementTime = currentTime;
             }
             UpdateGame(player, spears, gameOver, settings, gameState, frameCount, moveX, moveY);
+            if (gameOver) {
+                journal::EndSession(SCORE_TIMER, -1);
+                best_score = journal::BestScore(journal::Game::RUNNER, difficulty);
+            }
         }
+        particles::UpdateParticles(sim::TickSeconds());
+        telemetry::SetSpearCount(spears.size());
+        alloc_tracker::SetFrameSteady(gameState == GameState::PLAYING);
         RenderGame(renderer, font, player, spears, gameState, selectedOption, gameOver);
+        FrameDelayUs(sim::TickUs());
     }
+    resources::ReleaseFont(font);
     return 0;
 }
 
+int SpearRunnerVersusMain(SDL_Window* window, SDL_Renderer* renderer) {
+    TTF_Font* font = resources::AcquireFont(FONT_PATH, 28);
+    if (!font) {
+        logger::Error("Failed to load font! TTF_Error: %s", TTF_GetError());
+        logger::Error("Ensure the path '%s' is correct.", FONT_PATH);
+        return -1;  // main cleans up the window and renderer
+    }
+
+    srand(options.seed ? options.seed : time(0));
+
+    GameState gameState = GameState::MENU;
+    int selectedOption = 1; // 0=Easy, 1=Medium, 2=Hard, 3=Back
+    int loser = -1;
+    int frameCount = 0;
+    int survived = 0;       // seconds both runners have stayed clear
+    Uint32 lastTick = SDL_GetTicks();
+    Settings settings = GetSettingsForDifficulty(Difficulty::MEDIUM);
+
+    Player players[VERSUS_PLAYERS];
+    for (int i = 0; i < VERSUS_PLAYERS; i++) {
+        players[i].index = i;
+        players[i].rect.w = PLAYER_SIZE;
+        players[i].rect.h = PLAYER_SIZE;
+        players[i].facing = Direction::UP;
+    }
+
+    std::vector<Spear> spears;
+    spears.reserve(MAX_SPEARS);
+
+    while (true) {
+        printFPS();
+        input::PumpInput();
+
+        float moveX[VERSUS_PLAYERS] = {}, moveY[VERSUS_PLAYERS] = {};
+        GameState previous = gameState;
+
+        if (HandleVersusInput(players, gameState, selectedOption, settings, frameCount, spears, moveX, moveY) == -1) {
+            resources::ReleaseFont(font);
+            return -1;
+        }
+
+        if (gameState == GameState::MENU && RETURN_TO_MENU) {
+            RETURN_TO_MENU = 0;
+            resources::ReleaseFont(font);
+            return 0;
+        }
+
+        if (gameState == GameState::PLAYING) {
+            if (previous != GameState::PLAYING) {
+                loser = -1;
+                survived = 0;
+                lastTick = SDL_GetTicks();
+                journal::BeginSession(journal::Game::RUNNER_VERSUS, selectedOption);
+            }
+            Uint32 currentTime = SDL_GetTicks();
+            if (currentTime > lastTick + 1000) {
+                survived++;
+                lastTick = currentTime;
+            }
+            UpdateVersus(players, spears, loser, settings, gameState, frameCount, moveX, moveY);
+            if (loser == VERSUS_PLAYERS) logger::Info("Draw after %d s!", survived);
+            else if (loser >= 0) logger::Info("Player %d wins after %d s!", VERSUS_PLAYERS - loser, survived);
+            if (loser >= 0) journal::EndSession(survived, loser == VERSUS_PLAYERS ? -1 : VERSUS_PLAYERS - 1 - loser);
+        }
+        particles::UpdateParticles(sim::TickSeconds());
+        telemetry::SetSpearCount(spears.size());
+        alloc_tracker::SetFrameSteady(gameState == GameState::PLAYING);
+        RenderVersus(renderer, font, players, spears, gameState, selectedOption, survived, loser);
+        FrameDelayUs(sim::TickUs());
+    }
+}
+
 namespace spear_runner {
     Settings GetSettingsForDifficulty(Difficulty difficulty) {
         Settings settings;
@@ -81,10 +186,13 @@ namespace spear_runner {
 
     int HandleInput(Player& player, GameState& gameState, int& selectedOption, bool& gameOver, \
                     float& moveX, float& moveY, Settings settings, int& frameCount, std::vector<Spear>& spears) {
-        if (gameState == GameState::MENU) {
-            std::lock_guard<std::mutex> lock(joy_mutex);
-            if (joy_action) {
-                joy_action = false;
+        if (input::QuitRequested()) return -1;
+
+        input::InputEvent event;
+        bool stateChanged = false;
+        while (!stateChanged && input::PollInputEvent(event)) {
+            const Joystick& joy = event.state;
+            if (gameState == GameState::MENU) {
                 if (joy.y == UP) selectedOption = (selectedOption - 1 + 4) % 4;
                 else if (joy.y == DOWN) selectedOption = (selectedOption + 1) % 4;
                 else if (joy.btn == PRESSED) {
@@ -102,20 +210,21 @@ namespace spear_runner {
                         player.rect.x = static_cast<int>(player.x - player.rect.w / 2);
                         player.rect.y = static_cast<int>(player.y - player.rect.h / 2);
                         gameState = GameState::PLAYING;
+                        stateChanged = true;
                     }
                 }
             }
-        }
-        else if (gameState == GameState::GAME_OVER) {
-            std::lock_guard<std::mutex> lock(joy_mutex);
-            if (joy_action) {
-                joy_action = false;
-                if (joy.btn==PRESSED)
+            else if (gameState == GameState::GAME_OVER) {
+                if (joy.btn==PRESSED) {
                     gameState = GameState::MENU;
+                    stateChanged = true;
+                }
             }
         }
 
         if (gameState == GameState::PLAYING && !gameOver) {
+            // movement follows the held direction, not individual events
+            Joystick joy = input::CurrentJoystick();
             if (joy.y == UP) moveY = -PLAYER_SPEED;
             if (joy.y == DOWN) moveY = PLAYER_SPEED;
             if (joy.x == LEFT) moveX = -PLAYER_SPEED;
@@ -134,20 +243,22 @@ namespace spear_runner {
             RenderMenu(renderer, font, selectedOption);
         }
         else {
+            render_scale::BeginWorld(renderer);
             RenderPlayerCharacter(renderer, player, gameOverFlag, 0);
-            SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255);
-            RenderScore(renderer, font, SCORE_TIMER); // render score
-
             for (auto& spear : spears) {
                 RenderSpear(renderer, spear); // draw spears
             }
+            render_scale::EndWorld(renderer);
+            particles::RenderParticles(renderer);
+            SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255);
+            RenderScore(renderer, font, SCORE_TIMER); // render score
 
             if (gameState == GameState::GAME_OVER) {
-                RenderGameOver(renderer, font, SCORE_TIMER);
+                RenderGameOver(renderer, font, SCORE_TIMER, best_score);
             }
         }
 
-        SDL_RenderPresent(renderer);
+        capture::PresentFrame(renderer);
     }
 
     void SpawnSpears(std::vector<Spear>& spears, const Settings& settings) {
@@ -157,12 +268,32 @@ namespace spear_runner {
         else if (side == 1) { newSpear.originDirection = Direction::UP; newSpear.rect = {rand() % SCREEN_WIDTH, -15, 5, 15}; }
         else if (side == 2) { newSpear.originDirection = Direction::RIGHT; newSpear.rect = {SCREEN_WIDTH, rand() % SCREEN_HEIGHT, 15, 5}; }
         else { newSpear.originDirection = Direction::LEFT; newSpear.rect = { -15, rand() % SCREEN_HEIGHT, 15, 5}; }
+        newSpear.x = static_cast<float>(newSpear.rect.x);
+        newSpear.y = static_cast<float>(newSpear.rect.y);
+        newSpear.previous = newSpear.rect;
         spears.push_back(newSpear);
     }
 
     void UpdateGame(Player& player, std::vector<Spear>& spears, bool& gameOver, const Settings& settings, GameState& gameState, int& frameCount, float moveX, float moveY) {
-        player.x += moveX;
-        player.y += moveY;
+        SDL_Rect start = player.rect;
+        MovePlayer(player, moveX, moveY);
+        UpdateSpears(spears, settings, frameCount);
+
+        // check for collisions anywhere along this tick's moves, not just where they ended
+        for (auto& spear : spears) {
+            float toi;
+            if (collision::SweepRects(spear.previous, spear.rect, start, player.rect, toi)) {
+                particles::EmitHit(player.x, player.y);
+                gameOver = true;
+                gameState = GameState::GAME_OVER;
+                break;
+            }
+        }
+    }
+
+    void MovePlayer(Player& player, float moveX, float moveY) {
+        player.x += moveX * sim::TickScale();
+        player.y += moveY * sim::TickScale();
         player.rect.x = static_cast<int>(player.x - player.rect.w / 2);
         player.rect.y = static_cast<int>(player.y - player.rect.h / 2);
 
@@ -172,22 +303,29 @@ namespace spear_runner {
         if (player.rect.y + player.rect.h > SCREEN_HEIGHT) player.rect.y = SCREEN_HEIGHT - player.rect.h;
         player.x = player.rect.x + player.rect.w / 2.0f;
         player.y = player.rect.y + player.rect.h / 2.0f;
+    }
 
+    // spawn on schedule, move every spear and drop the ones that left the field
+    void UpdateSpears(std::vector<Spear>& spears, const Settings& settings, int& frameCount) {
         frameCount++;
-        if (frameCount >= settings.spawnRate) {
-            SpawnSpears(spears, settings);
+        if (frameCount >= sim::ScaleTicks(settings.spawnRate)) {
+            if (spears.size() < MAX_SPEARS) SpawnSpears(spears, settings);
             frameCount = 0;
         }
 
         // update spear positions
+        float step = settings.spearSpeed * sim::TickScale();
         for (auto& spear : spears) {
+            spear.previous = spear.rect;
             switch (spear.originDirection) {
-                case Direction::UP: spear.rect.y += settings.spearSpeed; break;
-                case Direction::DOWN: spear.rect.y -= settings.spearSpeed; break;
-                case Direction::LEFT: spear.rect.x += settings.spearSpeed; break;
-                case Direction::RIGHT: spear.rect.x -= settings.spearSpeed; break;
+                case Direction::UP: spear.y += step; break;
+                case Direction::DOWN: spear.y -= step; break;
+                case Direction::LEFT: spear.x += step; break;
+                case Direction::RIGHT: spear.x -= step; break;
                 case Direction::NONE: break;
             }
+            spear.rect.x = static_cast<int>(spear.x);
+            spear.rect.y = static_cast<int>(spear.y);
         }
 
         // remove spears that are out of bounds
@@ -197,14 +335,120 @@ namespace spear_runner {
                 spears.erase(spears.begin() + i);
             }
         }
+    }
 
-        // check for collisions
-        for (auto& spear : spears) {
-            if (SDL_HasIntersection(&player.rect, &spear.rect)) {
-                gameOver = true;
-                gameState = GameState::GAME_OVER;
-                break;
+    int HandleVersusInput(Player players[], GameState& gameState, int& selectedOption, Settings& settings, int& frameCount,
+                          std::vector<Spear>& spears, float moveX[], float moveY[]) {
+        if (input::QuitRequested()) return -1;
+
+        // menus answer either controller; during play the per-player queues are only drained
+        input::InputEvent event;
+        bool stateChanged = false;
+        while (!stateChanged && input::PollInputEvent(event)) {
+            const Joystick& joy = event.state;
+            if (gameState == GameState::MENU) {
+                if (joy.y == UP) selectedOption = (selectedOption - 1 + 4) % 4;
+                else if (joy.y == DOWN) selectedOption = (selectedOption + 1) % 4;
+                else if (joy.btn == PRESSED) {
+                    if (selectedOption == 3) {
+                        RETURN_TO_MENU = 1; // back selected
+                        return 0;
+                    }
+                    settings = GetSettingsForDifficulty(static_cast<Difficulty>(selectedOption));
+                    frameCount = 0;
+                    spears.clear();
+                    for (int i = 0; i < VERSUS_PLAYERS; i++) {
+                        Player& player = players[i];
+                        player.x = SCREEN_WIDTH * (i + 1) / (VERSUS_PLAYERS + 1.0f);
+                        player.y = SCREEN_HEIGHT / 2.0f;
+                        player.rect.x = static_cast<int>(player.x - player.rect.w / 2);
+                        player.rect.y = static_cast<int>(player.y - player.rect.h / 2);
+                    }
+                    gameState = GameState::PLAYING;
+                    stateChanged = true;
+                }
+            }
+            else if (gameState == GameState::GAME_OVER) {
+                if (joy.btn == PRESSED) {
+                    gameState = GameState::MENU;
+                    stateChanged = true;
+                }
             }
         }
+
+        if (gameState == GameState::PLAYING) {
+            for (int i = 0; i < VERSUS_PLAYERS; i++) {
+                Joystick joy = input::PlayerJoystick(i);
+                if (joy.y == UP) moveY[i] = -PLAYER_SPEED;
+                if (joy.y == DOWN) moveY[i] = PLAYER_SPEED;
+                if (joy.x == LEFT) moveX[i] = -PLAYER_SPEED;
+                if (joy.x == RIGHT) moveX[i] = PLAYER_SPEED;
+            }
+        }
+
+        return 0;
+    }
+
+    void UpdateVersus(Player players[], std::vector<Spear>& spears, int& loser, const Settings& settings, GameState& gameState, int& frameCount, const float moveX[], const float moveY[]) {
+        SDL_Rect start[VERSUS_PLAYERS];
+        for (int i = 0; i < VERSUS_PLAYERS; i++) {
+            start[i] = players[i].rect;
+            MovePlayer(players[i], moveX[i], moveY[i]);
+        }
+        UpdateSpears(spears, settings, frameCount);
+
+        // the runner hit first within the tick loses; hits at the same instant are a draw
+        float firstHit[VERSUS_PLAYERS];
+        float earliest = 2;     // past the end of the tick
+        for (int i = 0; i < VERSUS_PLAYERS; i++) {
+            firstHit[i] = 2;
+            for (const auto& spear : spears) {
+                float toi;
+                if (collision::SweepRects(spear.previous, spear.rect, start[i], players[i].rect, toi)) {
+                    firstHit[i] = std::min(firstHit[i], toi);
+                }
+            }
+            earliest = std::min(earliest, firstHit[i]);
+        }
+        if (earliest > 1) return;
+
+        int hits = 0;
+        for (int i = 0; i < VERSUS_PLAYERS; i++) {
+            if (firstHit[i] != earliest) continue;
+            loser = i;
+            hits++;
+            particles::EmitHit(players[i].x, players[i].y);
+        }
+        if (hits > 1) loser = VERSUS_PLAYERS;
+        gameState = GameState::GAME_OVER;
+    }
+
+    void RenderVersus(SDL_Renderer* renderer, TTF_Font* font, const Player players[], const std::vector<Spear>& spears, GameState gameState, int selectedOption, int survived, int loser) {
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+
+        if (gameState == GameState::MENU) {
+            RenderMenu(renderer, font, selectedOption);
+        }
+        else {
+            render_scale::BeginWorld(renderer);
+            for (int i = 0; i < VERSUS_PLAYERS; i++) {
+                RenderPlayerCharacter(renderer, players[i], loser == i || loser == VERSUS_PLAYERS, 0);
+            }
+            for (const auto& spear : spears) {
+                RenderSpear(renderer, spear);
+            }
+            render_scale::EndWorld(renderer);
+            particles::RenderParticles(renderer);
+            SDL_SetRenderDrawColor(renderer, 0, 0, 255, 255);
+            RenderScore(renderer, font, survived);
+
+            if (gameState == GameState::GAME_OVER) {
+                int winner = loser >= 0 && loser < VERSUS_PLAYERS ? VERSUS_PLAYERS - 1 - loser : -1;
+                RenderVersusGameOver(renderer, font, winner);
+            }
+        }
+
+        capture::PresentFrame(renderer);
     }
 }
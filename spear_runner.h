@@ -10,6 +10,8 @@
 #include <ctime>            // for time()
 
 int SpearRunnerMain(SDL_Window* window, SDL_Renderer* renderer);
+// two runners sharing one spear field, each on its own controller; the first one hit loses
+int SpearRunnerVersusMain(SDL_Window* window, SDL_Renderer* renderer);
 
 namespace spear_runner {
     inline int RETURN_TO_MENU; // flag to return to menu
@@ -36,6 +38,14 @@ namespace spear_runner {
     void RenderGame(SDL_Renderer* renderer, TTF_Font* font, const Player& player, const std::vector<Spear>& spears, GameState gameState, int selectedOption, bool gameOverFlag);
     void SpawnSpears(std::vector<Spear>& spears, const Settings& settings);
     void UpdateGame(Player& player, std::vector<Spear>& spears, bool& gameOver, const Settings& settings, GameState& gameState, int& frameCount, float moveX, float moveY);
+    void MovePlayer(Player& player, float moveX, float moveY);
+    void UpdateSpears(std::vector<Spear>& spears, const Settings& settings, int& frameCount);
+
+    // versus mode
+    int HandleVersusInput(Player players[], GameState& gameState, int& selectedOption, Settings& settings, int& frameCount,
+                          std::vector<Spear>& spears, float moveX[], float moveY[]);
+    void UpdateVersus(Player players[], std::vector<Spear>& spears, int& loser, const Settings& settings, GameState& gameState, int& frameCount, const float moveX[], const float moveY[]);
+    void RenderVersus(SDL_Renderer* renderer, TTF_Font* font, const Player players[], const std::vector<Spear>& spears, GameState gameState, int selectedOption, int survived, int loser);
 }
 
 #endif
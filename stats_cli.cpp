@@ -0,0 +1,115 @@
+// reads the once-per-second stats records published by a running game_menu
+// usage: game_stats [--socket PATH] [--json]
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "telemetry.h"
+
+static volatile sig_atomic_t stop = 0;
+
+static void HandleSignal(int) {
+    stop = 1;
+}
+
+static void PrintRecord(const telemetry::StatsRecord& r, const telemetry::StatsRecord& prev, bool json) {
+    // input counters are cumulative; show what happened since the previous record
+    uint32_t received = r.inputReceived - prev.inputReceived;
+    uint32_t dropped = r.inputDropped - prev.inputDropped;
+    uint32_t coalesced = r.inputCoalesced - prev.inputCoalesced;
+    uint32_t channels = r.channelCount < (uint32_t)telemetry::STATS_CHANNELS ? r.channelCount : telemetry::STATS_CHANNELS;
+    if (json) {
+        printf("{\"seq\": %llu, \"uptime_ms\": %llu, \"frames\": %u, \"p50_ms\": %.2f, \"p90_ms\": %.2f, \"p99_ms\": %.2f, "
+               "\"max_ms\": %.2f, \"spears\": %u, \"draw_calls\": %u, \"input_received\": %u, \"input_dropped\": %u, "
+               "\"input_coalesced\": %u, \"reconnects\": %u, \"latency_us\": %d, \"bridge_latency_us\": %d, "
+               "\"drift_ppm\": %.2f, \"jitter_spikes\": %u, \"log_dropped\": %u, \"wake_late_avg_us\": %u, "
+               "\"wake_late_max_us\": %u, \"governor_level\": %u, \"governor_transitions\": %u, \"channels\": [",
+               (unsigned long long)r.sequence, (unsigned long long)r.uptimeMs, r.frames, r.frameP50Ms, r.frameP90Ms,
+               r.frameP99Ms, r.frameMaxMs, r.spearCount, r.drawCallsPerFrame, r.inputReceived, r.inputDropped,
+               r.inputCoalesced, r.readerReconnects, r.inputLatencyUs, r.bridgeLatencyUs, r.clockDriftPpm, r.jitterSpikes,
+               r.logDropped, r.wakeLateAvgUs, r.wakeLateMaxUs, r.governorLevel, r.governorTransitions);
+        for (uint32_t i = 0; i < channels; i++) {
+            printf("%s{\"latency_us\": %d, \"reconnects\": %u}", i ? ", " : "", r.channelLatencyUs[i], r.channelReconnects[i]);
+        }
+        printf("]}\n");
+    }
+    else {
+        printf("%8.1fs  fps %4u  frame p50 %6.2f p90 %6.2f p99 %6.2f max %6.2f ms  spears %3u  draws/frame %5u  "
+               "input +%u (dropped +%u, coalesced +%u)  reconnects %u  latency %.1f ms (bridge %.1f ms, "
+               "drift %.1f ppm, spikes %u)  log dropped %u  wake late avg %u max %u us  governor %u (%u changes)",
+               r.uptimeMs / 1000.0, r.frames, r.frameP50Ms, r.frameP90Ms, r.frameP99Ms, r.frameMaxMs,
+               r.spearCount, r.drawCallsPerFrame, received, dropped, coalesced, r.readerReconnects,
+               r.inputLatencyUs / 1000.0, r.bridgeLatencyUs / 1000.0, r.clockDriftPpm, r.jitterSpikes,
+               r.logDropped, r.wakeLateAvgUs, r.wakeLateMaxUs, r.governorLevel, r.governorTransitions);
+        // per controller only once there is more than one
+        for (uint32_t i = 0; channels > 1 && i < channels; i++) {
+            if (r.channelLatencyUs[i] < 0) printf("  p%u -", i + 1);
+            else printf("  p%u %.1f ms", i + 1, r.channelLatencyUs[i] / 1000.0);
+        }
+        printf("\n");
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char* argv[]) {
+    const char* path = telemetry::DEFAULT_SOCKET_PATH;
+    bool json = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--socket") && i + 1 < argc) path = argv[++i];
+        else if (!strcmp(argv[i], "--json")) json = true;
+        else {
+            std::cerr << "usage: " << argv[0] << " [--socket PATH] [--json]\n";
+            return 1;
+        }
+    }
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        std::cerr << "Socket path too long: " << path << "\n";
+        return 1;
+    }
+    strcpy(address.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        perror("Error creating socket");
+        return 1;
+    }
+    unlink(path);   // stale socket from a previous reader
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+        perror("Error binding stats socket");
+        return 1;
+    }
+
+    // no SA_RESTART, so recv() returns on ctrl-c and the socket file gets removed
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = HandleSignal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    if (!json) std::cout << "Listening on " << path << "..." << "\n";
+    telemetry::StatsRecord record, prev;
+    memset(&prev, 0, sizeof(prev));
+    while (!stop) {
+        ssize_t n = recv(fd, &record, sizeof(record), 0);
+        if (n < 0) continue;    // interrupted
+        if (n != sizeof(record) || record.magic != telemetry::STATS_MAGIC || record.version != telemetry::STATS_VERSION) {
+            std::cerr << "Ignoring unknown record (" << n << " bytes)" << "\n";
+            continue;
+        }
+        // a restarted game starts counting from zero again
+        if (record.sequence <= prev.sequence) memset(&prev, 0, sizeof(prev));
+        PrintRecord(record, prev, json);
+        prev = record;
+    }
+
+    close(fd);
+    unlink(path);
+    return 0;
+}
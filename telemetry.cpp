@@ -0,0 +1,127 @@
+#include "telemetry.h"
+#include "governor.h"
+#include "input.h"
+#include "logger.h"
+#include "realtime.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace telemetry {
+    uint32_t draw_calls = 0;
+    uint32_t spear_count = 0;
+}
+
+static_assert(telemetry::STATS_CHANNELS == MAX_INPUT_CHANNELS, "stats record must cover every input channel");
+
+namespace {
+    const int MAX_FRAME_SAMPLES = 1024;     // per interval; headless runs can exceed this
+    const double PUBLISH_INTERVAL = 1.0;    // seconds
+
+    int stats_socket = -1;
+    sockaddr_un stats_address;
+    uint64_t sequence = 0;
+    Uint64 start_us = 0;
+
+    float frame_ms[MAX_FRAME_SAMPLES];
+    uint32_t frames = 0;
+    double interval = 0;
+    float max_frame_ms = 0;
+    uint64_t interval_draw_calls = 0;
+
+    float Percentile(int count, int percent) {
+        int index = std::min(count - 1, count * percent / 100);
+        std::nth_element(frame_ms, frame_ms + index, frame_ms + count);
+        return frame_ms[index];
+    }
+
+    void Publish() {
+        telemetry::StatsRecord record;
+        memset(&record, 0, sizeof(record));
+        record.magic = telemetry::STATS_MAGIC;
+        record.version = telemetry::STATS_VERSION;
+        record.sequence = ++sequence;
+        record.uptimeMs = (input::NowUs() - start_us) / 1000;
+
+        int samples = std::min<int>(frames, MAX_FRAME_SAMPLES);
+        record.frames = frames;
+        if (samples > 0) {
+            record.frameP50Ms = Percentile(samples, 50);
+            record.frameP90Ms = Percentile(samples, 90);
+            record.frameP99Ms = Percentile(samples, 99);
+        }
+        record.frameMaxMs = max_frame_ms;
+        record.spearCount = telemetry::spear_count;
+        record.drawCallsPerFrame = frames ? static_cast<uint32_t>(interval_draw_calls / frames) : 0;
+
+        input::InputStats inputStats = input::GetInputStats();
+        record.inputReceived = inputStats.received;
+        record.inputDropped = inputStats.dropped;
+        record.inputCoalesced = inputStats.coalesced;
+        record.readerReconnects = inputStats.reconnects;
+        const input::ChannelStats& first = inputStats.channels[0];
+        record.inputLatencyUs = static_cast<int32_t>(first.lastLatencyUs);
+        record.bridgeLatencyUs = static_cast<int32_t>(first.lastBridgeLatencyUs);
+        record.clockDriftPpm = static_cast<float>(first.clockDriftPpm);
+        record.jitterSpikes = first.jitterSpikes;
+        record.channelCount = inputStats.channelCount;
+        for (int i = 0; i < telemetry::STATS_CHANNELS; i++) {
+            const input::ChannelStats& channel = inputStats.channels[i];
+            record.channelLatencyUs[i] = channel.timestamped ? static_cast<int32_t>(channel.lastLatencyUs) : -1;
+            record.channelReconnects[i] = channel.reconnects;
+        }
+        record.logDropped = static_cast<uint32_t>(logger::GetLogStats().dropped);
+        realtime::WakeStats wake = realtime::TakeIntervalWakeStats();
+        record.wakeLateAvgUs = wake.wakes ? static_cast<uint32_t>(wake.totalLateUs / wake.wakes) : 0;
+        record.wakeLateMaxUs = static_cast<uint32_t>(wake.maxLateUs);
+        governor::GovernorStats governorStats = governor::GetGovernorStats();
+        record.governorLevel = static_cast<uint32_t>(governorStats.level);
+        record.governorTransitions = static_cast<uint32_t>(governorStats.transitions);
+
+        // nobody listening (ENOENT/ECONNREFUSED) or a full reader queue (EAGAIN) just drops the record
+        sendto(stats_socket, &record, sizeof(record), MSG_DONTWAIT,
+               reinterpret_cast<const sockaddr*>(&stats_address), sizeof(stats_address));
+    }
+}
+
+namespace telemetry {
+    void InitTelemetry(const char* socketPath) {
+        start_us = input::NowUs();
+        if (strlen(socketPath) >= sizeof(stats_address.sun_path)) {
+            logger::Error("Stats socket path too long: %s", socketPath);
+            return;
+        }
+        stats_socket = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (stats_socket < 0) {
+            logger::Error("Error creating stats socket: %s", strerror(errno));
+            return;
+        }
+        memset(&stats_address, 0, sizeof(stats_address));
+        stats_address.sun_family = AF_UNIX;
+        strcpy(stats_address.sun_path, socketPath);
+    }
+
+    void ShutdownTelemetry() {
+        if (stats_socket >= 0) close(stats_socket);
+        stats_socket = -1;
+    }
+
+    void RecordFrame(double seconds) {
+        float ms = static_cast<float>(seconds * 1000.0);
+        if (frames < MAX_FRAME_SAMPLES) frame_ms[frames] = ms;
+        frames++;
+        if (ms > max_frame_ms) max_frame_ms = ms;
+        interval_draw_calls += draw_calls;
+        draw_calls = 0;
+
+        interval += seconds;
+        if (interval < PUBLISH_INTERVAL) return;
+        if (stats_socket >= 0) Publish();
+        frames = 0;
+        interval = 0;
+        max_frame_ms = 0;
+        interval_draw_calls = 0;
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+
+// once-per-second stats record published over a unix datagram socket
+// kept free of SDL so the game_stats reader can include it on its own
+namespace telemetry {
+    const uint32_t STATS_MAGIC = 0x42565354;    // "BVST"
+    const uint32_t STATS_VERSION = 6;
+    const char* const DEFAULT_SOCKET_PATH = "/tmp/boyvspear_stats.sock";
+    const int STATS_CHANNELS = 4;               // BLE controller FIFOs reported individually
+
+    struct StatsRecord {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t sequence;
+        uint64_t uptimeMs;
+        // frame times over the last interval
+        uint32_t frames;
+        float frameP50Ms, frameP90Ms, frameP99Ms, frameMaxMs;
+        // game state at publish time
+        uint32_t spearCount;
+        uint32_t drawCallsPerFrame;
+        // cumulative input counters
+        uint32_t inputReceived;
+        uint32_t inputDropped;
+        uint32_t inputCoalesced;
+        uint32_t readerReconnects;
+        // live latency of timestamped BLE input (ESP32 -> bridge -> game), player 1's controller
+        int32_t inputLatencyUs;
+        int32_t bridgeLatencyUs;
+        float clockDriftPpm;
+        uint32_t jitterSpikes;
+        // every controller channel, -1 latency when a channel has no timestamped input yet
+        uint32_t channelCount;
+        int32_t channelLatencyUs[STATS_CHANNELS];
+        uint32_t channelReconnects[STATS_CHANNELS];
+        // log records lost to full logger rings
+        uint32_t logDropped;
+        // how late the render thread woke for its frame deadlines over the last interval
+        uint32_t wakeLateAvgUs;
+        uint32_t wakeLateMaxUs;
+        // render detail the frame-budget governor is at (0 = full) and how often it changed
+        uint32_t governorLevel;
+        uint32_t governorTransitions;
+    };
+
+    // render-thread counters, cheap enough to bump per draw
+    extern uint32_t draw_calls;
+    extern uint32_t spear_count;
+
+    inline void CountDrawCalls(uint32_t count) { draw_calls += count; }
+    inline void SetSpearCount(uint32_t count) { spear_count = count; }
+
+    void InitTelemetry(const char* socketPath);
+    void ShutdownTelemetry();
+
+    // called once per frame with the frame time; publishes a record every second
+    void RecordFrame(double seconds);
+}
+
+#endif